@@ -1,3 +1,5 @@
+#include <iostream>
+
 #include "argparse.hpp"
 
 using argparse::ArgValue;
@@ -62,45 +64,31 @@ struct ZeroOneRange {
     }
 };
 
+#ifdef ARGPARSE_EXAMPLE_PRERENDERED_HELP
+//Generated at build time by the argparse_example_help generator (see CMakeLists.txt)
+extern const argparse::PrerenderedHelp example_help;
+#endif
+
+void add_arguments(argparse::ArgumentParser& parser, Args& args);
+
+#ifdef ARGPARSE_EXAMPLE_HELP_GENERATOR
+//Built as a generator, which writes the help to be embedded in the example
 int main(int argc, const char** argv) {
     Args args;
     auto parser = argparse::ArgumentParser(argv[0], "My application description");
+    add_arguments(parser, args);
 
-    parser.version("Version: 0.0.1");
-
-    parser.add_argument(args.filename, "filename")
-        .help("File to process");
-
-    parser.add_argument(args.do_foo, "--foo")
-        .help("Causes foo")
-        .default_value("false")
-        .action(argparse::Action::STORE_TRUE);
-
-    parser.add_argument<bool,OnOff>(args.enable_bar, "--bar")
-        .help("Control whether bar is enabled")
-        .default_value("off");
-
-    parser.add_argument(args.verbosity, "--verbosity", "-v")
-        .help("Sets the verbosity")
-        .default_value("1")
-        .choices({"0", "1", "2"});
-    parser.add_argument(args.show_version, "--version", "-V")
-        .help("Show version information")
-        .action(argparse::Action::VERSION);
-
-    parser.add_argument<float,ZeroOneRange>(args.utilization, "--util")
-        .help("Sets target utilization")
-        .default_value("1.0");
+    return argparse::prerender_help_main(argc, argv, parser);
+}
+#else
+int main(int argc, const char** argv) {
+    Args args;
+    auto parser = argparse::ArgumentParser(argv[0], "My application description");
+    add_arguments(parser, args);
 
-    parser.add_argument(args.zulus, "--zulu")
-        .help("One or more float values")
-        .nargs('+')
-        .default_value({"1.0", "0.2"});
-
-    parser.add_argument(args.alphas, "--alphas")
-        .help("Zero or more float values")
-        .nargs('*')
-        .default_value({});
+#ifdef ARGPARSE_EXAMPLE_PRERENDERED_HELP
+    parser.prerendered_help(&example_help);
+#endif
 
     parser.parse_args(argc, argv);
 
@@ -137,4 +125,43 @@ int main(int argc, const char** argv) {
 
     return 0;
 }
+#endif
+
+//Defines the example's arguments, shared by the example and its help generator
+void add_arguments(argparse::ArgumentParser& parser, Args& args) {
+    parser.version("Version: 0.0.1");
+
+    parser.add_argument(args.filename, "filename")
+        .help("File to process");
+
+    parser.add_argument(args.do_foo, "--foo")
+        .help("Causes foo")
+        .default_value("false")
+        .action(argparse::Action::STORE_TRUE);
+
+    parser.add_argument<bool,OnOff>(args.enable_bar, "--bar")
+        .help("Control whether bar is enabled")
+        .default_value("off");
+
+    parser.add_argument(args.verbosity, "--verbosity", "-v")
+        .help("Sets the verbosity")
+        .default_value("1")
+        .choices({"0", "1", "2"});
+    parser.add_argument(args.show_version, "--version", "-V")
+        .help("Show version information")
+        .action(argparse::Action::VERSION);
 
+    parser.add_argument<float,ZeroOneRange>(args.utilization, "--util")
+        .help("Sets target utilization")
+        .default_value("1.0");
+
+    parser.add_argument(args.zulus, "--zulu")
+        .help("One or more float values")
+        .nargs('+')
+        .default_value({"1.0", "0.2"});
+
+    parser.add_argument(args.alphas, "--alphas")
+        .help("Zero or more float values")
+        .nargs('*')
+        .default_value({});
+}
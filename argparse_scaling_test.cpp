@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "argparse.hpp"
+#include "argparse_synthetic.hpp"
+
+//Allowed growth in per-token cost, generous enough to absorb timing noise (and cache
+//effects as the schema grows), but far below the growth caused by per-token work
+//proportional to the command-line length or the number of options
+constexpr double MAX_LENGTH_COST_RATIO = 4.; //Over 8x longer command lines (quadratic cost grows 8x)
+constexpr double MAX_OPTION_COST_RATIO = 10.; //Over 100x more options (linear cost grows 100x)
+
+double best_parse_time(argparse::ArgumentParser& parser, const std::vector<std::string>& tokens, size_t num_reps);
+
+int main() {
+    int num_failed = 0;
+
+    //Generated command lines parse (or fail to parse) as expected
+    {
+        SyntheticSchema schema(10, 30, 42);
+        argparse::ArgumentParser parser("synthetic");
+        schema.add_arguments(parser);
+
+        for (size_t iline = 0; iline < 200; ++iline) {
+            auto tokens = schema.valid_command_line(iline % 50);
+            try {
+                parser.parse_args_throw(tokens);
+            } catch (const argparse::ArgParseError& e) {
+                std::cout << "[FAIL] Valid synthetic command line failed to parse: " << e.what() << std::endl;
+                ++num_failed;
+                break;
+            }
+        }
+
+        for (size_t iline = 0; iline < 200; ++iline) {
+            auto tokens = schema.invalid_command_line(iline % 50);
+            try {
+                parser.parse_args_throw(tokens);
+                std::cout << "[FAIL] Invalid synthetic command line parsed:";
+                for (const auto& token : tokens) {
+                    std::cout << " " << token;
+                }
+                std::cout << std::endl;
+                ++num_failed;
+                break;
+            } catch (const argparse::ArgParseError&) {
+                //Expected
+            }
+        }
+    }
+
+    //Parse time is near-linear in the command-line length
+    {
+        SyntheticSchema schema(50, 40);
+        argparse::ArgumentParser parser("synthetic");
+        schema.add_arguments(parser);
+
+        std::vector<double> token_costs;
+        for (size_t num_options_used : {250, 500, 1000, 2000}) {
+            auto tokens = schema.valid_command_line(num_options_used);
+            token_costs.push_back(best_parse_time(parser, tokens, 10) / tokens.size());
+        }
+
+        double ratio = token_costs.back() / *std::min_element(token_costs.begin(), token_costs.end());
+        if (ratio > MAX_LENGTH_COST_RATIO) {
+            std::cout << "[FAIL] Per-token parse cost grew " << ratio << "x with 8x longer command lines" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Per-token parse cost grew " << ratio << "x with 8x longer command lines" << std::endl;
+        }
+    }
+
+    //The cost of each token does not depend on the number of options. Each parse also has
+    //a fixed cost (resetting every destination), which is excluded by subtracting the time
+    //to parse an empty command line.
+    {
+        std::vector<double> token_costs;
+        for (size_t num_groups : {2, 20, 200}) {
+            SyntheticSchema schema(num_groups, 50);
+            argparse::ArgumentParser parser("synthetic");
+            schema.add_arguments(parser);
+
+            auto tokens = schema.valid_command_line(100);
+            double fixed_time = best_parse_time(parser, {}, 20);
+            double time = best_parse_time(parser, tokens, 20);
+            //Guard against timing noise making the difference non-positive
+            token_costs.push_back(std::max(time - fixed_time, 1e-9) / tokens.size());
+        }
+
+        double ratio = token_costs.back() / *std::min_element(token_costs.begin(), token_costs.end());
+        if (ratio > MAX_OPTION_COST_RATIO) {
+            std::cout << "[FAIL] Per-token parse cost grew " << ratio << "x with 100x more options" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Per-token parse cost grew " << ratio << "x with 100x more options" << std::endl;
+        }
+    }
+
+    return num_failed;
+}
+
+//Returns the fastest of num_reps parses of tokens (in seconds)
+double best_parse_time(argparse::ArgumentParser& parser, const std::vector<std::string>& tokens, size_t num_reps) {
+    double best = std::numeric_limits<double>::max();
+    for (size_t irep = 0; irep < num_reps; ++irep) {
+        auto start = std::chrono::steady_clock::now();
+        parser.parse_args_throw(tokens);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
@@ -0,0 +1,108 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "argparse.hpp"
+#include "argparse_server.hpp"
+#include "argparse_synthetic.hpp"
+
+/*
+ * Measures the throughput of a ValidationServer over loopback
+ *
+ * Starts a server (with NUM_WORKERS workers) whose parsers are defined by a synthetic
+ * schema, and validates generated command-lines (one in ten invalid) from 1, 4 and 16
+ * concurrent clients, each waiting for every response before sending its next
+ * request. Reports the command-lines validated per second, and the mean round trip.
+ *
+ * Usage: argparse_server_benchmark [NUM_REQUESTS [NUM_WORKERS]]
+ */
+
+//Parser owning its schema's destinations, as a ValidationServer worker requires
+class SyntheticParser : public argparse::ArgumentParser {
+    public:
+        SyntheticParser()
+            : argparse::ArgumentParser("synthetic")
+            , schema_(10, 30) {
+            schema_.add_arguments(*this);
+        }
+    private:
+        SyntheticSchema schema_;
+};
+
+struct Request {
+    std::vector<std::string> args;
+    bool valid;
+};
+
+bool run_clients(const std::string& socket_path, const std::vector<Request>& requests, size_t num_clients);
+
+int main(int argc, const char** argv) {
+    size_t num_requests = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t num_workers = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 4;
+    if (num_requests == 0 || num_workers == 0 || argc > 3) {
+        std::fprintf(stderr, "usage: %s [NUM_REQUESTS [NUM_WORKERS]]\n", argv[0]);
+        return 1;
+    }
+
+    //The same seed as the servers' parsers, so the command-lines match their schema
+    SyntheticSchema schema(10, 30);
+    std::vector<Request> requests;
+    for (size_t irequest = 0; irequest < num_requests; ++irequest) {
+        bool valid = (irequest % 10 != 9);
+        requests.push_back({valid ? schema.valid_command_line(irequest % 20) : schema.invalid_command_line(irequest % 20), valid});
+    }
+
+    std::string socket_path = "/tmp/argparse_server_benchmark." + std::to_string(::getpid()) + ".sock";
+    argparse::ValidationServer server(socket_path, []() { return std::make_shared<SyntheticParser>(); }, num_workers);
+    std::thread server_thread([&]() { server.serve(); });
+
+    std::printf("%zu requests, %zu workers\n", num_requests, num_workers);
+    std::printf("%8s %14s %16s\n", "clients", "requests/s", "round trip (us)");
+    bool ok = true;
+    for (size_t num_clients : {1, 4, 16}) {
+        if (!run_clients(socket_path, requests, num_clients)) {
+            ok = false;
+            break;
+        }
+    }
+
+    server.stop();
+    server_thread.join();
+    return ok ? 0 : 1;
+}
+
+//Validates requests split across num_clients concurrent clients, reporting the throughput
+bool run_clients(const std::string& socket_path, const std::vector<Request>& requests, size_t num_clients) {
+    std::atomic<size_t> num_unexpected(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t iclient = 0; iclient < num_clients; ++iclient) {
+        clients.emplace_back([&, iclient]() {
+            argparse::ValidationClient client(socket_path);
+            for (size_t irequest = iclient; irequest < requests.size(); irequest += num_clients) {
+                if (client.validate(requests[irequest].args) != requests[irequest].valid) {
+                    ++num_unexpected;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (num_unexpected > 0) {
+        std::fprintf(stderr, "%zu unexpected validation results\n", num_unexpected.load());
+        return false;
+    }
+    double requests_per_second = requests.size() / elapsed.count();
+    std::printf("%8zu %14.0f %16.1f\n", num_clients, requests_per_second, 1e6 * num_clients / requests_per_second);
+    return true;
+}
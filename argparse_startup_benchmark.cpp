@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * Measures the start-up latency of a short-lived program using libargparse
+ *
+ * Repeatedly forks and execs each tool (by default argparse_startup_tool, built both
+ * against the shared C++ runtime and with it linked statically), which reports (through
+ * a pipe) when it reaches each stage of its start-up. Reports the median and minimum
+ * time spent in:
+ *
+ *   exec + static init: from just before exec to entering main() (loading, relocation
+ *                       and the dynamic initialization of globals)
+ *   construction:       constructing the ArgumentParser
+ *   registration:       adding the arguments
+ *   parsing:            parsing the command line
+ *
+ * Usage: argparse_startup_benchmark [NUM_RUNS [TOOL ...]]
+ */
+
+constexpr size_t NUM_STAGES = 4;
+const char* const STAGE_NAMES[NUM_STAGES] = {"exec + static init", "construction", "registration", "parsing"};
+
+uint64_t monotonic_ns();
+bool benchmark_tool(const std::string& tool, size_t num_runs);
+bool run_tool(const std::string& tool, uint64_t stage_ns[NUM_STAGES]);
+std::vector<std::string> default_tools(const char* argv0);
+
+int main(int argc, const char** argv) {
+    size_t num_runs = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200;
+    std::vector<std::string> tools(argv + std::min(argc, 2), argv + argc);
+    if (tools.empty()) {
+        tools = default_tools(argv[0]);
+    }
+    if (num_runs == 0) {
+        std::fprintf(stderr, "usage: %s [NUM_RUNS [TOOL ...]]\n", argv[0]);
+        return 1;
+    }
+
+    for (const auto& tool : tools) {
+        if (!benchmark_tool(tool, num_runs)) {
+            std::fprintf(stderr, "Failed to run '%s'\n", tool.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//Runs the tool num_runs times, and reports the time spent in each stage
+bool benchmark_tool(const std::string& tool, size_t num_runs) {
+    std::vector<uint64_t> stage_times[NUM_STAGES];
+    std::vector<uint64_t> total_times;
+    for (size_t irun = 0; irun < num_runs; ++irun) {
+        uint64_t stage_ns[NUM_STAGES];
+        if (!run_tool(tool, stage_ns)) {
+            return false;
+        }
+
+        uint64_t total = 0;
+        for (size_t istage = 0; istage < NUM_STAGES; ++istage) {
+            stage_times[istage].push_back(stage_ns[istage]);
+            total += stage_ns[istage];
+        }
+        total_times.push_back(total);
+    }
+
+    auto report = [](const char* name, std::vector<uint64_t>& times) {
+        std::sort(times.begin(), times.end());
+        std::printf("%-20s median %9.1f us   min %9.1f us\n", name, times[times.size() / 2] / 1e3, times[0] / 1e3);
+    };
+    std::printf("\n%zu runs of %s\n", num_runs, tool.c_str());
+    for (size_t istage = 0; istage < NUM_STAGES; ++istage) {
+        report(STAGE_NAMES[istage], stage_times[istage]);
+    }
+    report("total", total_times);
+    return true;
+}
+
+//Runs the tool once, returning the time spent in each stage (in nanoseconds)
+bool run_tool(const std::string& tool, uint64_t stage_ns[NUM_STAGES]) {
+    int fds[2];
+    if (::pipe(fds) != 0) return false;
+
+    std::string fd_str = std::to_string(fds[1]);
+    const char* tool_argv[] = {tool.c_str(), "--foo", "-v", "2", "--zulu", "0.5", "0.25", "--mode", "slow", "input.txt", nullptr};
+
+    uint64_t exec_time = monotonic_ns();
+    pid_t pid = ::fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        ::close(fds[0]);
+        ::setenv("ARGPARSE_STARTUP_FD", fd_str.c_str(), 1);
+        exec_time = monotonic_ns();
+        //Report when exec started, since fork() may take a while to return in the child
+        if (::write(fds[1], &exec_time, sizeof(exec_time)) == sizeof(exec_time)) {
+            ::execv(tool.c_str(), const_cast<char* const*>(tool_argv));
+        }
+        ::_exit(127);
+    }
+    ::close(fds[1]);
+
+    //The exec time followed by the tool's stage times
+    uint64_t times[NUM_STAGES + 1];
+    size_t num_read = 0;
+    while (num_read < sizeof(times)) {
+        ssize_t n = ::read(fds[0], reinterpret_cast<char*>(times) + num_read, sizeof(times) - num_read);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        num_read += n;
+    }
+    ::close(fds[0]);
+
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    if (num_read != sizeof(times) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return false;
+    }
+
+    for (size_t istage = 0; istage < NUM_STAGES; ++istage) {
+        stage_ns[istage] = times[istage + 1] - times[istage];
+    }
+    return true;
+}
+
+//Returns the paths of the tool variants, assumed to be next to the benchmark
+std::vector<std::string> default_tools(const char* argv0) {
+    std::string path = argv0;
+    size_t slash = path.rfind('/');
+    std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash);
+
+    std::vector<std::string> tools = {dir + "/argparse_startup_tool"};
+    std::string static_tool = dir + "/argparse_startup_tool_static_runtime";
+    if (::access(static_tool.c_str(), X_OK) == 0) {
+        tools.push_back(static_tool);
+    }
+    return tools;
+}
+
+//Returns CLOCK_MONOTONIC, which is comparable between processes
+uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
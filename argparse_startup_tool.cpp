@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+
+#include <unistd.h>
+
+#include "argparse.hpp"
+
+/*
+ * A minimal short-lived tool (with arguments like argparse_example's), run repeatedly
+ * by argparse_startup_benchmark. If ARGPARSE_STARTUP_FD names a file descriptor, the
+ * times at which main() is entered, the parser is constructed, the arguments are
+ * registered and the command line is parsed are written to it.
+ */
+
+struct Args {
+    argparse::ArgValue<std::string> filename;
+    argparse::ArgValue<bool> do_foo;
+    argparse::ArgValue<size_t> verbosity;
+    argparse::ArgValue<float> utilization;
+    argparse::ArgValue<std::vector<float>> zulus;
+    argparse::ArgValue<std::string> mode;
+    argparse::ArgValue<int> seed;
+};
+
+uint64_t monotonic_ns();
+
+int main(int argc, const char** argv) {
+    uint64_t times[4];
+    times[0] = monotonic_ns();
+
+    Args args;
+    auto parser = argparse::ArgumentParser(argv[0], "Startup benchmark tool");
+    times[1] = monotonic_ns();
+
+    parser.version("Version: 0.0.1");
+
+    parser.add_argument(args.filename, "filename")
+        .help("File to process");
+    parser.add_argument(args.do_foo, "--foo")
+        .help("Causes foo")
+        .default_value("false")
+        .action(argparse::Action::STORE_TRUE);
+    parser.add_argument(args.verbosity, "--verbosity", "-v")
+        .help("Sets the verbosity")
+        .default_value("1")
+        .choices({"0", "1", "2"});
+    parser.add_argument(args.utilization, "--util")
+        .help("Sets target utilization")
+        .default_value("1.0");
+    parser.add_argument(args.zulus, "--zulu")
+        .help("One or more float values")
+        .nargs('+')
+        .default_value({"1.0", "0.2"});
+
+    auto& extra_grp = parser.add_argument_group("extra options");
+    extra_grp.add_argument(args.mode, "--mode")
+        .help("Operating mode")
+        .default_value("fast")
+        .choices({"fast", "slow", "auto"});
+    extra_grp.add_argument(args.seed, "--seed")
+        .help("Random seed")
+        .default_value("1");
+    times[2] = monotonic_ns();
+
+    parser.parse_args(argc, argv);
+    times[3] = monotonic_ns();
+
+    const char* fd_str = std::getenv("ARGPARSE_STARTUP_FD");
+    if (fd_str) {
+        if (::write(std::atoi(fd_str), times, sizeof(times)) != sizeof(times)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//Returns CLOCK_MONOTONIC, which is comparable between processes
+uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "argparse.hpp"
+#include "argparse_synthetic.hpp"
+
+/*
+ * Measures the throughput of ArgumentParser::parse_stream()
+ *
+ * Writes NUM_RECORDS generated command-lines (one in ten invalid) for a synthetic
+ * schema to a temporary file, NUL terminated with newline record separators, and
+ * parses the file with several chunk sizes. Reports the records and megabytes parsed
+ * per second for each.
+ *
+ * Usage: argparse_stream_benchmark [NUM_RECORDS]
+ */
+
+size_t write_records(SyntheticSchema& schema, size_t num_records, std::FILE* file);
+
+int main(int argc, const char** argv) {
+    size_t num_records = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    if (num_records == 0 || argc > 2) {
+        std::fprintf(stderr, "usage: %s [NUM_RECORDS]\n", argv[0]);
+        return 1;
+    }
+
+    SyntheticSchema schema(10, 30);
+    argparse::ArgumentParser parser("synthetic");
+    schema.add_arguments(parser);
+
+    std::FILE* file = std::tmpfile();
+    if (!file) {
+        std::fprintf(stderr, "Failed to create temporary file\n");
+        return 1;
+    }
+    size_t num_invalid = write_records(schema, num_records, file);
+    int fd = fileno(file);
+
+    std::printf("%zu records (%zu invalid)\n", num_records, num_invalid);
+    std::printf("%12s %14s %10s\n", "chunk size", "records/s", "MB/s");
+    for (size_t chunk_size : {4096, 64 * 1024, 1024 * 1024}) {
+        if (::lseek(fd, 0, SEEK_SET) != 0) {
+            std::fprintf(stderr, "Failed to rewind temporary file\n");
+            return 1;
+        }
+
+        auto stats = parser.parse_stream(fd, [](size_t, const argparse::ArgParseError*) {}, chunk_size);
+        if (stats.num_records != num_records || stats.num_failed != num_invalid) {
+            std::fprintf(stderr, "Unexpected results: %zu records (%zu failed)\n", stats.num_records, stats.num_failed);
+            return 1;
+        }
+        std::printf("%12zu %14.0f %10.1f\n", chunk_size, stats.records_per_second(), stats.num_bytes / stats.seconds / 1e6);
+    }
+    std::fclose(file);
+    return 0;
+}
+
+//Writes num_records command-lines to file, returning the number which are invalid
+size_t write_records(SyntheticSchema& schema, size_t num_records, std::FILE* file) {
+    size_t num_invalid = 0;
+    for (size_t irecord = 0; irecord < num_records; ++irecord) {
+        std::vector<std::string> tokens;
+        if (irecord % 10 == 9) {
+            tokens = schema.invalid_command_line(irecord % 20);
+            ++num_invalid;
+        } else {
+            tokens = schema.valid_command_line(irecord % 20);
+        }
+        for (const auto& token : tokens) {
+            std::fwrite(token.c_str(), 1, token.size() + 1, file); //Including the NUL
+        }
+        std::fputc('\n', file);
+    }
+    std::fflush(file);
+    return num_invalid;
+}
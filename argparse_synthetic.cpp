@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <numeric>
+
+#include "argparse_synthetic.hpp"
+
+constexpr size_t SyntheticSchema::NUM_OPTION_KINDS;
+
+SyntheticSchema::SyntheticSchema(size_t num_groups, size_t options_per_group, uint32_t seed)
+    : num_groups_(num_groups)
+    , options_per_group_(options_per_group)
+    , rng_(seed) {
+
+    //Short options for the first options ('-h' is reserved for help)
+    std::string short_chars = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    size_t num_options = num_groups_ * options_per_group_;
+    for (size_t i = 0; i < num_options; ++i) {
+        Option option;
+        option.kind = static_cast<OptionKind>(i % NUM_OPTION_KINDS);
+        option.long_opt = "--group" + std::to_string(i / options_per_group_) + "_option" + std::to_string(i);
+        if (i < short_chars.size()) {
+            option.short_opt = std::string("-") + short_chars[i];
+        }
+        if (option.kind == OptionKind::CHOICE) {
+            size_t num_choices = 2 + rng_() % 4;
+            for (size_t ichoice = 0; ichoice < num_choices; ++ichoice) {
+                option.choices.push_back("choice" + std::to_string(ichoice));
+            }
+        }
+        options_.push_back(option);
+    }
+}
+
+void SyntheticSchema::add_arguments(argparse::ArgumentParser& parser) {
+    for (size_t igroup = 0; igroup < num_groups_; ++igroup) {
+        auto& group = parser.add_argument_group("group " + std::to_string(igroup));
+
+        for (size_t i = igroup * options_per_group_; i < (igroup + 1) * options_per_group_; ++i) {
+            const Option& option = options_[i];
+            switch (option.kind) {
+                case OptionKind::INT:
+                    int_values_.emplace_back();
+                    group.add_argument(int_values_.back(), option.long_opt, option.short_opt)
+                        .help("An integer");
+                    break;
+                case OptionKind::FLOAT:
+                    float_values_.emplace_back();
+                    group.add_argument(float_values_.back(), option.long_opt, option.short_opt)
+                        .default_value("0.5")
+                        .help("A float");
+                    break;
+                case OptionKind::CHOICE:
+                    string_values_.emplace_back();
+                    group.add_argument(string_values_.back(), option.long_opt, option.short_opt)
+                        .choices(option.choices)
+                        .default_value(option.choices[0])
+                        .help("One of several choices");
+                    break;
+                case OptionKind::FLAG:
+                    bool_values_.emplace_back();
+                    group.add_argument(bool_values_.back(), option.long_opt, option.short_opt)
+                        .action(argparse::Action::STORE_TRUE)
+                        .help("A flag");
+                    break;
+                case OptionKind::STRING:
+                    string_values_.emplace_back();
+                    group.add_argument(string_values_.back(), option.long_opt, option.short_opt)
+                        .metavar("NAME")
+                        .help("A string");
+                    break;
+                case OptionKind::LIST:
+                    list_values_.emplace_back();
+                    group.add_argument(list_values_.back(), option.long_opt, option.short_opt)
+                        .nargs('+')
+                        .help("One or more integers");
+                    break;
+                default:
+                    throw argparse::ArgParseError("Unrecognized synthetic option kind");
+            }
+        }
+    }
+}
+
+size_t SyntheticSchema::num_options() const {
+    return options_.size();
+}
+
+std::vector<std::string> SyntheticSchema::valid_command_line(size_t num_options_used) {
+    std::vector<std::string> tokens;
+    for (size_t i : pick_options(num_options_used)) {
+        append_option(options_[i], tokens);
+    }
+    return tokens;
+}
+
+std::vector<std::string> SyntheticSchema::invalid_command_line(size_t num_options_used) {
+    enum class ErrorKind {
+        UNKNOWN_OPTION,
+        MALFORMED_VALUE,
+        UNEXPECTED_CHOICE,
+        MISSING_VALUE
+    };
+    ErrorKind error = static_cast<ErrorKind>(rng_() % 4);
+
+    //The option to misuse, which must not also be used validly
+    std::vector<size_t> picked = pick_options(options_.size());
+    OptionKind target_kind = (error == ErrorKind::UNEXPECTED_CHOICE) ? OptionKind::CHOICE : OptionKind::INT;
+    auto target = std::find_if(picked.begin(), picked.end(), [&](size_t i) {
+        return options_[i].kind == target_kind;
+    });
+    if (target == picked.end()) {
+        error = ErrorKind::UNKNOWN_OPTION;
+    }
+
+    std::vector<std::string> bad_tokens;
+    if (error == ErrorKind::UNKNOWN_OPTION) {
+        bad_tokens = {"--no_such_option" + std::to_string(rng_() % 1000)};
+    } else {
+        const Option& option = options_[*target];
+        bad_tokens.push_back(option.long_opt);
+        if (error == ErrorKind::MALFORMED_VALUE) {
+            bad_tokens.push_back("not_an_int");
+        } else if (error == ErrorKind::UNEXPECTED_CHOICE) {
+            bad_tokens.push_back("no_such_choice");
+        }
+        //else MISSING_VALUE: followed by another option (or the end of the command line)
+        picked.erase(target);
+    }
+    picked.resize(std::min(picked.size(), num_options_used));
+
+    //Insert the error at a random option boundary
+    size_t error_pos = rng_() % (picked.size() + 1);
+    std::vector<std::string> tokens;
+    for (size_t ipick = 0; ipick <= picked.size(); ++ipick) {
+        if (ipick == error_pos) {
+            tokens.insert(tokens.end(), bad_tokens.begin(), bad_tokens.end());
+        }
+        if (ipick < picked.size()) {
+            append_option(options_[picked[ipick]], tokens);
+        }
+    }
+    return tokens;
+}
+
+void SyntheticSchema::append_option(const Option& option, std::vector<std::string>& tokens) {
+    if (!option.short_opt.empty() && rng_() % 2) {
+        tokens.push_back(option.short_opt);
+    } else {
+        tokens.push_back(option.long_opt);
+    }
+
+    switch (option.kind) {
+        case OptionKind::INT:
+            tokens.push_back(std::to_string(rng_() % 1000000));
+            break;
+        case OptionKind::FLOAT:
+            tokens.push_back(std::to_string((rng_() % 1000) / 8.));
+            break;
+        case OptionKind::CHOICE:
+            tokens.push_back(option.choices[rng_() % option.choices.size()]);
+            break;
+        case OptionKind::FLAG:
+            break;
+        case OptionKind::STRING:
+            tokens.push_back("value" + std::to_string(rng_() % 1000));
+            break;
+        case OptionKind::LIST:
+            for (size_t ivalue = 0, num_values = 1 + rng_() % 4; ivalue < num_values; ++ivalue) {
+                tokens.push_back(std::to_string(rng_() % 1000));
+            }
+            break;
+        default:
+            throw argparse::ArgParseError("Unrecognized synthetic option kind");
+    }
+}
+
+std::vector<size_t> SyntheticSchema::pick_options(size_t num_options_used) {
+    num_options_used = std::min(num_options_used, options_.size());
+
+    //Partial Fisher-Yates shuffle
+    std::vector<size_t> indices(options_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    for (size_t i = 0; i < num_options_used; ++i) {
+        size_t j = i + rng_() % (indices.size() - i);
+        std::swap(indices[i], indices[j]);
+    }
+    indices.resize(num_options_used);
+    return indices;
+}
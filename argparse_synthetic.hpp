@@ -0,0 +1,79 @@
+#ifndef ARGPARSE_SYNTHETIC_HPP
+#define ARGPARSE_SYNTHETIC_HPP
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse.hpp"
+
+/*
+ * SyntheticSchema generates large parser definitions (and matching command lines)
+ * for stress tests and benchmarks.
+ *
+ * The schema consists of num_groups groups of options_per_group options, cycling
+ * through integer, float, choice, flag, string and multi-value (integer) options.
+ * The first options also receive single character short options. Everything is
+ * derived from the seed, so a given schema and its command lines are reproducible.
+ */
+class SyntheticSchema {
+    public:
+        SyntheticSchema(size_t num_groups, size_t options_per_group, uint32_t seed=1);
+
+        SyntheticSchema(const SyntheticSchema&) = delete;
+        SyntheticSchema& operator=(const SyntheticSchema&) = delete;
+
+        //Adds the schema's groups and options to parser
+        // The destinations are owned by the schema, so it must outlive the parser
+        void add_arguments(argparse::ArgumentParser& parser);
+
+        //Returns the total number of options in the schema
+        size_t num_options() const;
+
+        //Returns a valid command line specifying num_options_used distinct options
+        //(all of them if num_options_used exceeds num_options())
+        std::vector<std::string> valid_command_line(size_t num_options_used);
+
+        //Returns a command line which is valid except for a single error (an unknown
+        //option, a malformed or unexpected value, or a missing value)
+        std::vector<std::string> invalid_command_line(size_t num_options_used);
+
+    private:
+        enum class OptionKind {
+            INT,
+            FLOAT,
+            CHOICE,
+            FLAG,
+            STRING,
+            LIST      //nargs '+'
+        };
+        static constexpr size_t NUM_OPTION_KINDS = 6;
+
+        struct Option {
+            OptionKind kind;
+            std::string long_opt;
+            std::string short_opt;
+            std::vector<std::string> choices;
+        };
+
+        //Appends the tokens specifying option (with valid values) to tokens
+        void append_option(const Option& option, std::vector<std::string>& tokens);
+
+        //Returns num_options_used distinct option indicies, in random order
+        std::vector<size_t> pick_options(size_t num_options_used);
+    private:
+        size_t num_groups_;
+        size_t options_per_group_;
+        std::vector<Option> options_;
+        std::mt19937 rng_;
+
+        //Destinations, in deques so their addresses are stable
+        std::deque<argparse::ArgValue<int>> int_values_;
+        std::deque<argparse::ArgValue<float>> float_values_;
+        std::deque<argparse::ArgValue<std::string>> string_values_;
+        std::deque<argparse::ArgValue<bool>> bool_values_;
+        std::deque<argparse::ArgValue<std::vector<int>>> list_values_;
+};
+
+#endif
@@ -1,5 +1,24 @@
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+#ifdef ARGPARSE_TEST_SERVER
+# include <chrono>
+# include <cstring>
+# include <thread>
+# include <poll.h>
+# include <sys/socket.h>
+# include <sys/un.h>
+# include <unistd.h>
+#endif
+
 #include "argparse.hpp"
 #include "argparse_util.hpp"
+#ifdef ARGPARSE_TEST_SERVER
+# include "argparse_server.hpp"
+#endif
 
 using argparse::ArgValue;
 using argparse::ConvertedValue;
@@ -93,6 +112,23 @@ struct Args {
 
 bool expect_pass(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line);
 bool expect_fail(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line);
+bool expect_completions(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line, size_t cursor, std::vector<std::string> expected);
+bool expect_fail_delta(argparse::ArgumentParser& parser, std::vector<std::string> changed_args, std::vector<std::string> removed_options);
+
+#ifdef ARGPARSE_TEST_SERVER
+//Parser owning its destinations, as each ValidationServer worker requires
+class JobsParser : public argparse::ArgumentParser {
+    public:
+        JobsParser()
+            : argparse::ArgumentParser("jobs") {
+            add_argument(jobs_, "--jobs", "-j").default_value("1");
+            add_argument(files_, "--files").nargs('*');
+        }
+    private:
+        ArgValue<int> jobs_;
+        ArgValue<std::vector<std::string>> files_;
+};
+#endif
 
 struct OnOff {
     ConvertedValue<bool> from_str(std::string str) {
@@ -116,6 +152,73 @@ struct OnOff {
     }
 };
 
+//A value which counts how often it is copied and moved
+struct CopyCounted {
+    CopyCounted() = default;
+    explicit CopyCounted(std::string str) : value(str) {}
+    CopyCounted(const CopyCounted& other) : value(other.value) { ++num_copies; }
+    CopyCounted(CopyCounted&& other) noexcept : value(std::move(other.value)) { ++num_moves; }
+    CopyCounted& operator=(const CopyCounted& other) { value = other.value; ++num_copies; return *this; }
+    CopyCounted& operator=(CopyCounted&& other) noexcept { value = std::move(other.value); ++num_moves; return *this; }
+
+    std::string value;
+    static size_t num_copies;
+    static size_t num_moves;
+};
+size_t CopyCounted::num_copies = 0;
+size_t CopyCounted::num_moves = 0;
+
+struct CopyCountedConverter {
+    ConvertedValue<CopyCounted> from_str(std::string str) {
+        ConvertedValue<CopyCounted> converted_value;
+        converted_value.set_value(CopyCounted(str));
+        return converted_value;
+    }
+
+    ConvertedValue<std::string> to_str(const CopyCounted& val) {
+        ConvertedValue<std::string> converted_value;
+        converted_value.set_value(val.value);
+        return converted_value;
+    }
+
+    std::vector<std::string> default_choices() {
+        return {};
+    }
+};
+
+//A user type converted by DefaultConverter through its stream operators (and not trivially
+//copyable, so snapshots store it as a string)
+struct Ratio {
+    Ratio() = default;
+    explicit Ratio(double val) : value(val) {}
+    Ratio(const Ratio& other) : value(other.value) {}
+    Ratio& operator=(const Ratio& other) { value = other.value; return *this; }
+
+    double value = 0.;
+
+    friend bool operator==(const Ratio& lhs, const Ratio& rhs) { return lhs.value == rhs.value; }
+    friend std::ostream& operator<<(std::ostream& os, const Ratio& ratio) { return os << ratio.value; }
+    friend std::istream& operator>>(std::istream& is, Ratio& ratio) { return is >> ratio.value; }
+};
+
+//A memory resource which counts the allocations it forwards to the global heap
+class CountingResource : public argparse::MemoryResource {
+    public:
+        size_t num_allocations = 0;
+        size_t bytes_in_use = 0;
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++num_allocations;
+            bytes_in_use += bytes;
+            return argparse::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+            bytes_in_use -= bytes;
+            argparse::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+};
+
 int main(
         int 
 #ifndef TEST
@@ -502,6 +605,11 @@ int main(
         {"my_arch6.xml", "--analysis", "--one_or_more", "3.24", "10", "29", "my_circuit6.blif"}, //positional after nargs='+'
         {"my_arch6.xml", "--analysis", "--one_or_more", "3.24", "10", "29", "my_circuit6.blif"}, //positional after nargs='+'
         {"my_arch6.xml", "--analysis", "--zero_or_more", "3.24", "10", "29", "my_circuit6.blif"}, //positional after nargs='*'
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan_width=300"}, //Attached value for long option
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--slack_definition=I"}, //Attached value with choices
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--one_or_more=3.24", "10", "29"}, //Attached first value for nargs='+'
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--zero_or_more", "234", "--one_or_more=284"}, //Attached value ends nargs='*'
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route"}, //Exact match which is also a prefix of other options
     };
 
     int num_failed = 0;
@@ -529,6 +637,15 @@ int main(
         {"my_arch17.xml", "my_circuit17.blif"}, //Missing required
         {"my_arch6.xml", "my_circuit6.blif", "--analysis", "-j", "3.4"}, //Float when expected unsigned
         {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--one_or_more"}, //Expected at least one argument
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan_width="}, //Empty attached value
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan_width=off"}, //Wrong attached value type
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis=on"}, //Attached value to toggle option
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--no_such_option=3"}, //Unknown option with attached value
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--seed", "1", "--seed", "2"}, //Single value specified multiple times
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan_widthx", "300"}, //Not a prefix
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan", "300"}, //Abbreviation (not allowed by default)
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--rout_chan_wdth", "300"}, //Misspelled option
+        {"my_arch6.xml", "my_circuit6.blif", "--analysis", "--seeed=3"}, //Misspelled option with attached value
     };
 
     for(const auto& cmd_line : fail_cases) {
@@ -540,6 +657,1105 @@ int main(
         }
     }
 
+    //Unrecognized options suggest similar ones
+    {
+        struct SuggestionCase {
+            std::vector<std::string> cmd_line;
+            std::string expected; //Expected in the error message (or, if empty, no suggestion)
+        };
+        std::vector<SuggestionCase> suggestion_cases = {
+            {{"my_arch6.xml", "my_circuit6.blif", "--analysis", "--rout_chan_wdth", "300"}, "did you mean '--route_chan_width'?"}, //Misspelled option
+            {{"my_arch6.xml", "my_circuit6.blif", "--analysis", "--seeed=3"}, "did you mean '--seed'?"}, //Misspelled option with attached value
+            {{"my_arch6.xml", "my_circuit6.blif", "--analysis", "--route_chan", "300"}, "did you mean '--route_chan_width'?"}, //Abbreviation
+            {{"my_arch6.xml", "my_circuit6.blif", "--analysis", "-z"}, ""}, //Unknown short option
+        };
+        for (const auto& suggestion_case : suggestion_cases) {
+            std::string error;
+            try {
+                parser.parse_args_throw(suggestion_case.cmd_line);
+            } catch (const argparse::ArgParseError& e) {
+                error = e.what();
+            }
+            parser.reset_destinations();
+
+            bool ok = suggestion_case.expected.empty()
+                    ? (!error.empty() && error.find("did you mean") == std::string::npos)
+                    : (error.find(suggestion_case.expected) != std::string::npos);
+            if (!ok) {
+                std::cout << "[FAIL] Unexpected suggestion for '" << argparse::join(suggestion_case.cmd_line, " ") << "': " << error << std::endl;
+                ++num_failed;
+            } else {
+                std::cout << "[PASS] " << error << std::endl;
+            }
+        }
+    }
+
+    //Abbreviated long options
+    {
+        ArgValue<size_t> route_chan_width;
+        ArgValue<std::string> router_algorithm;
+        ArgValue<bool> analysis;
+        ArgValue<std::vector<float>> one_or_more, zero_or_more;
+        argparse::ArgumentParser abbrev_parser("abbrev");
+        abbrev_parser.allow_abbrev(true);
+        abbrev_parser.add_argument(route_chan_width, "--route_chan_width");
+        abbrev_parser.add_argument(router_algorithm, "--router_algorithm");
+        abbrev_parser.add_argument(analysis, "--analysis").action(argparse::Action::STORE_TRUE);
+        abbrev_parser.add_argument(one_or_more, "--one_or_more").nargs('+');
+        abbrev_parser.add_argument(zero_or_more, "--zero_or_more").nargs('*');
+
+        std::vector<std::vector<std::string>> abbrev_pass_cases = {
+            {"--route_chan", "300"},                          //Unique abbreviation
+            {"--route_chan=300"},                             //Unique abbreviation with attached value
+            {"--analy"},                                      //Unique abbreviation of flag
+            {"--route_chan_width", "300"},                    //Exact match
+            {"--zero_or_more", "234", "--one_or", "284"},     //Abbreviation ends nargs='*'
+        };
+        for (const auto& cmd_line : abbrev_pass_cases) {
+            if (!expect_pass(abbrev_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        std::vector<std::vector<std::string>> abbrev_fail_cases = {
+            {"--rout", "300"},                //Ambiguous abbreviation
+            {"--route_chan_widthx", "300"},   //Not a prefix
+        };
+        for (const auto& cmd_line : abbrev_fail_cases) {
+            if (!expect_fail(abbrev_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        abbrev_parser.parse_args_throw({"--route_chan=300"});
+        if (route_chan_width.value() != 300 || route_chan_width.argument_name() != "--route_chan_width") {
+            std::cout << "[FAIL] Abbreviation did not set the option it abbreviates" << std::endl;
+            ++num_failed;
+        }
+        abbrev_parser.reset_destinations();
+    }
+
+    //Packed short flags
+    {
+        ArgValue<bool> flag_x, flag_y;
+        ArgValue<size_t> jobs;
+        ArgValue<std::vector<float>> values;
+        argparse::ArgumentParser packed_parser("packed");
+        packed_parser.add_argument(flag_x, "--flag_x", "-x").action(argparse::Action::STORE_TRUE);
+        packed_parser.add_argument(flag_y, "--flag_y", "-y").action(argparse::Action::STORE_FALSE);
+        packed_parser.add_argument(jobs, "--jobs", "-j").default_value("1");
+        packed_parser.add_argument(values, "--values").nargs('*');
+
+        std::vector<std::vector<std::string>> packed_pass_cases = {
+            {"-xy"},                         //Packed short flags
+            {"-xyj3"},                       //Packed short flags, last with attached value
+            {"-yxj", "3"},                   //Packed short flags, last with separate value
+            {"--values", "234", "-xy"},      //Packed short flags end nargs='*'
+        };
+        for (const auto& cmd_line : packed_pass_cases) {
+            if (!expect_pass(packed_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        std::vector<std::vector<std::string>> packed_fail_cases = {
+            {"-xz"}, //Unknown option in packed short flags
+            {"-xj"}, //Missing value for last packed short option
+        };
+        for (const auto& cmd_line : packed_fail_cases) {
+            if (!expect_fail(packed_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        packed_parser.parse_args_throw({"-yxj3"});
+        if (!flag_x.value() || flag_y.value() || jobs.value() != 3) {
+            std::cout << "[FAIL] Unexpected values from packed short flags" << std::endl;
+            ++num_failed;
+        }
+        packed_parser.reset_destinations();
+    }
+
+    //Re-parsing without resetting restores defaults overwritten by the previous parse
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "-j", "3"});
+    for (int iparse = 0; iparse < 2; ++iparse) {
+        parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis"});
+        if (args.num_workers != 1 || args.num_workers.provenance() != argparse::Provenance::DEFAULT) {
+            std::cout << "[FAIL] Default not restored on re-parse " << iparse << std::endl;
+            ++num_failed;
+        }
+    }
+    if (args.num_workers.argument_name() != "--num_workers/-j" || args.num_workers.argument_group() != "general options"
+        || args.architecture_file.argument_name() != "architecture") {
+        std::cout << "[FAIL] Unexpected argument name or group recorded in destination" << std::endl;
+        ++num_failed;
+    }
+    parser.reset_destinations();
+
+    //Incremental changes to the previously parsed command-line
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "--alpha_t", "0.8"});
+    struct DeltaCase {
+        std::vector<std::string> changed_args;
+        std::vector<std::string> removed_options;
+        size_t expected_num_changed;
+    };
+    std::vector<DeltaCase> delta_cases = {
+        {{"--alpha_t", "0.9"}, {}, 1}, //Changed value
+        {{"--alpha_t", "0.9"}, {}, 0}, //Unchanged value
+        {{"--seed", "3", "--pack"}, {}, 2}, //Added options
+        {{}, {"--alpha_t", "--pack"}, 2}, //Removed options
+    };
+    for (const auto& delta_case : delta_cases) {
+        auto changed = parser.parse_args_delta(delta_case.changed_args, delta_case.removed_options);
+        if (changed.size() != delta_case.expected_num_changed) {
+            std::cout << "[FAIL] Expected " << delta_case.expected_num_changed << " changed arguments for delta '"
+                      << argparse::join(delta_case.changed_args, " ") << "' (found " << changed.size() << ")" << std::endl;
+            ++num_failed;
+        }
+    }
+    if (args.alpha_t != 0.01f || args.alpha_t.provenance() != argparse::Provenance::DEFAULT
+        || args.seed != 3 || args.pack || args.architecture_file.value() != "my_arch.xml") {
+        std::cout << "[FAIL] Unexpected values after command-line changes" << std::endl;
+        ++num_failed;
+    }
+    std::vector<DeltaCase> fail_delta_cases = {
+        {{}, {"--analysis"}, 0}, //Removed required option
+        {{}, {"--not_an_option"}, 0}, //Removed unknown option
+        {{"--seed", "1", "--seed", "2"}, {}, 0}, //Specified multiple times
+        {{"my_arch.xml"}, {}, 0}, //Changed positional
+    };
+    for (const auto& delta_case : fail_delta_cases) {
+        //A failed delta leaves the parser requiring a full parse
+        parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis"});
+        if (!expect_fail_delta(parser, delta_case.changed_args, delta_case.removed_options)) {
+            ++num_failed;
+        }
+    }
+    parser.reset_destinations();
+
+    //Change tracking between consecutive parses
+    size_t num_alpha_t_changes = 0;
+    size_t num_changes = 0;
+    parser.on_change([&](const argparse::ArgumentParser&) { ++num_alpha_t_changes; }, {"--alpha_t"});
+    parser.on_change([&](const argparse::ArgumentParser&) { ++num_changes; });
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis"});
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis"}); //Unchanged
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "--seed", "5"});
+    if (!parser.changed("--seed") || parser.changed("--alpha_t") || parser.changed("circuit")
+        || parser.changed_arguments().size() != 1) {
+        std::cout << "[FAIL] Unexpected changed arguments after specifying --seed" << std::endl;
+        ++num_failed;
+    }
+    parser.parse_args_delta({"--alpha_t", "0.5"});
+    if (num_alpha_t_changes != 2 || num_changes != 3) {
+        std::cout << "[FAIL] Unexpected number of change callbacks (--alpha_t: " << num_alpha_t_changes
+                  << ", any: " << num_changes << ")" << std::endl;
+        ++num_failed;
+    }
+    parser.track_changes(false);
+    parser.reset_destinations();
+
+    //Values convert to strings with the stream's default precision, but are stored in snapshots exactly
+    {
+        auto converted = argparse::DefaultConverter<Ratio>().to_str(Ratio(1.25));
+        auto converted_float = argparse::DefaultConverter<float>().to_str(0.01f);
+        if (!converted || converted.value() != "1.25" || !converted_float || converted_float.value() != "0.01") {
+            std::cout << "[FAIL] Expected values to convert to '1.25' and '0.01'" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Values converted to '1.25' and '0.01'" << std::endl;
+        }
+
+        ArgValue<Ratio> ratio;
+        argparse::ArgumentParser ratio_parser("ratio");
+        ratio_parser.add_argument(ratio, "--ratio");
+        ratio_parser.parse_args_throw({"--ratio", "0.30000000000000004"});
+        std::stringstream ss;
+        ratio_parser.save_snapshot(ss);
+        ratio_parser.reset_destinations();
+        std::string snapshot = ss.str();
+        ratio_parser.load_snapshot(snapshot.data(), snapshot.size());
+        if (ratio.value().value != 0.1 + 0.2) {
+            std::cout << "[FAIL] User type value changed by snapshot" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //Binary snapshots restore the parsed values and provenance without re-parsing
+    parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "--seed", "5", "--alpha_t", "0.25",
+                             "--one_or_more", "1.5", "2.5", "--pack"});
+    {
+        const char* snapshot_file = "argparse_test.snapshot";
+        std::ofstream os(snapshot_file, std::ios::binary);
+        parser.save_snapshot(os);
+        os.close();
+
+        parser.reset_destinations();
+        parser.load_snapshot(snapshot_file);
+        std::remove(snapshot_file);
+
+        if (args.architecture_file.value() != "my_arch.xml" || args.seed != 5 || args.alpha_t != 0.25f
+            || args.one_or_more.value() != std::vector<float>({1.5, 2.5}) || !args.pack
+            || args.seed.provenance() != argparse::Provenance::SPECIFIED
+            || args.num_workers.provenance() != argparse::Provenance::DEFAULT
+            || args.zero_or_more.provenance() != argparse::Provenance::UNSPECIFIED
+            || args.seed.argument_name() != "--seed") {
+            std::cout << "[FAIL] Unexpected values after loading snapshot" << std::endl;
+            ++num_failed;
+        }
+
+        //Continue from the restored state
+        auto changed = parser.parse_args_delta({"--seed", "6"});
+        if (changed.size() != 1 || args.seed != 6) {
+            std::cout << "[FAIL] Unexpected values after applying changes to loaded snapshot" << std::endl;
+            ++num_failed;
+        }
+
+        //Snapshots can only be loaded by parsers with the same arguments
+        std::stringstream ss;
+        parser.save_snapshot(ss);
+        std::string snapshot = ss.str();
+
+        ArgValue<int> other_value;
+        argparse::ArgumentParser other_parser("other");
+        other_parser.add_argument(other_value, "--seed");
+
+        std::string truncated(snapshot, 0, snapshot.size() - 1);
+        for (auto* load_parser : {&other_parser, &parser}) {
+            const std::string& data = (load_parser == &parser) ? truncated : snapshot;
+            try {
+                load_parser->load_snapshot(data.data(), data.size());
+                std::cout << "[FAIL] Loaded invalid snapshot OK when expected fail" << std::endl;
+                ++num_failed;
+            } catch (const argparse::ArgParseError& err) {
+                std::cout << "[PASS] " << err.what() << std::endl;
+            }
+        }
+    }
+    parser.reset_destinations();
+
+    //Equivalent command-lines produce the same canonical command-line and hash
+    {
+        std::vector<std::vector<std::string>> equivalent_cmd_lines = {
+            {"my_arch.xml", "my_circuit.blif", "--analysis", "-j", "3", "--seed", "05", "--pack", "--alpha_t=0.5"},
+            {"my_arch.xml", "--alpha_t", "0.5", "--pack", "--seed", "5", "my_circuit.blif", "--num_workers", "3", "--analysis",
+             "--timing_analysis", "on"}, //Reordered, long options and a value equal to the default
+        };
+        std::vector<std::string> expected_canonical = {"my_arch.xml", "my_circuit.blif", "--alpha_t", "0.5", "--analysis",
+                                                       "--num_workers", "3", "--pack", "--seed", "5"};
+        for (const auto& cmd_line : equivalent_cmd_lines) {
+            parser.parse_args_throw(cmd_line);
+            auto canonical = parser.canonical_command_line();
+            if (canonical != expected_canonical) {
+                std::cout << "[FAIL] Unexpected canonical command-line '" << argparse::join(canonical, " ")
+                          << "' for '" << argparse::join(cmd_line, " ") << "'" << std::endl;
+                ++num_failed;
+            }
+        }
+        uint64_t hash = parser.canonical_hash();
+
+        parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "-j", "3", "--seed", "6", "--pack", "--alpha_t=0.5"});
+        if (parser.canonical_hash() == hash) {
+            std::cout << "[FAIL] Same canonical hash for differing command-lines" << std::endl;
+            ++num_failed;
+        }
+    }
+    parser.reset_destinations();
+
+    //Dump of the parsed values
+    {
+        parser.parse_args_throw({"my_arch.xml", "my_circuit.blif", "--analysis", "--seed", "5", "-j", "3", "--one_or_more", "1.5", "2.5"});
+        std::string json_lines;
+        parser.dump_values(json_lines);
+        std::stringstream csv;
+        parser.dump_values(csv, argparse::ValueDumpFormat::CSV);
+
+        std::vector<std::pair<std::string,std::string>> expected_records = {
+            {json_lines, "{\"name\":\"--seed\",\"value\":\"5\",\"provenance\":\"specified\",\"group\":\"placement options\"}\n"},
+            {json_lines, "{\"name\":\"--one_or_more\",\"value\":[\"1.5\",\"2.5\"],\"provenance\":\"specified\",\"group\":\"test options\"}\n"},
+            {csv.str(), "name,value,provenance,group\n"},
+            {csv.str(), "\n--num_workers/-j,3,specified,general options\n"},
+            {csv.str(), "\n--alpha_t,0.01,default,placement options\n"},
+        };
+        for (const auto& expected : expected_records) {
+            if (expected.first.find(expected.second) == std::string::npos) {
+                std::cout << "[FAIL] Value dump missing '" << expected.second << "'" << std::endl;
+                ++num_failed;
+            }
+        }
+    }
+    parser.reset_destinations();
+
+    //Schema export for external tools
+    {
+        std::stringstream ss;
+        parser.write_schema_json(ss);
+        std::string schema = ss.str();
+        for (const auto& expected : {"\"long_option\":\"--num_workers\",\"short_option\":\"-j\"",
+                                     "\"default\":\"1\",\"show_in\":\"help_only\",\"type\":\"non-negative integer\"",
+                                     "\"choices\":[\"on\",\"off\"]"}) {
+            if (schema.find(expected) == std::string::npos) {
+                std::cout << "[FAIL] Schema missing '" << expected << "'" << std::endl;
+                ++num_failed;
+            }
+        }
+
+        std::string cache_file = parser.write_schema_cache(".");
+        std::ifstream is(cache_file);
+        std::string cached((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        if (cached != schema || parser.write_schema_cache(".") != cache_file) {
+            std::cout << "[FAIL] Unexpected cached schema '" << cache_file << "'" << std::endl;
+            ++num_failed;
+        }
+        std::remove(cache_file.c_str());
+    }
+
+    //Parsed values are moved (not copied) from the converter to the destination
+    {
+        ArgValue<CopyCounted> counted;
+        ArgValue<std::vector<CopyCounted>> counted_multi;
+        argparse::ArgumentParser counted_parser("counted");
+        counted_parser.add_argument<CopyCounted,CopyCountedConverter>(counted, "--counted");
+        counted_parser.add_argument<CopyCounted,CopyCountedConverter>(counted_multi, "--counted_multi").nargs('+');
+
+        CopyCounted::num_copies = 0;
+        CopyCounted::num_moves = 0;
+        counted_parser.parse_args_throw({"--counted", "a", "--counted_multi", "b", "c"});
+        if (CopyCounted::num_copies != 0 || counted.value().value != "a" || counted_multi.value().size() != 2) {
+            std::cout << "[FAIL] Parsed values copied " << CopyCounted::num_copies << " times ("
+                      << CopyCounted::num_moves << " moves)" << std::endl;
+            ++num_failed;
+        }
+
+        //Implicit conversion does not copy either
+        const CopyCounted& counted_ref = counted;
+        if (CopyCounted::num_copies != 0 || &counted_ref != &counted.value()) {
+            std::cout << "[FAIL] Implicit conversion copied value" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //C-string values are stored in the parser's string arena, which is re-used by each parse
+    {
+        ArgValue<const char*> cstr;
+        ArgValue<const char*> cstr_default;
+        argparse::ArgumentParser cstr_parser("cstr");
+        cstr_parser.add_argument(cstr, "--cstr");
+        cstr_parser.add_argument(cstr_default, "--cstr_default").default_value("default");
+        cstr_parser.track_changes(true);
+        for (size_t iparse = 0; iparse < 1000; ++iparse) {
+            std::string value = "value" + std::to_string(iparse / 500);
+            cstr_parser.parse_args_throw({"--cstr", value});
+            if (value != cstr.value() || std::string("default") != cstr_default.value()
+                || cstr_parser.changed("--cstr") != (iparse % 500 == 0)) {
+                std::cout << "[FAIL] Unexpected C-string value on parse " << iparse << std::endl;
+                ++num_failed;
+                break;
+            }
+        }
+
+        argparse::StringArena arena;
+        for (size_t ireset = 0; ireset < 3; ++ireset) {
+            for (size_t istr = 0; istr < 1000; ++istr) {
+                arena.store("string" + std::to_string(istr));
+            }
+            if (arena.capacity() > 4 * 4096) {
+                std::cout << "[FAIL] String arena capacity grew to " << arena.capacity() << std::endl;
+                ++num_failed;
+            }
+            arena.reset();
+        }
+    }
+
+    //C-string values replaced by parse_args_delta() are reclaimed, so repeated changes use bounded memory
+    {
+        CountingResource counting;
+        ArgValue<const char*> name;
+        ArgValue<const char*> kept;
+        argparse::ArgumentParser delta_parser("delta", "", &counting);
+        delta_parser.add_argument(name, "--name");
+        delta_parser.add_argument(kept, "--kept");
+        delta_parser.parse_args_throw({"--name", "initial", "--kept", "kept"});
+
+        size_t bytes_in_use = 0;
+        for (size_t idelta = 0; idelta < 10000; ++idelta) {
+            std::string value = "name" + std::to_string(idelta) + std::string(100, 'x');
+            delta_parser.parse_args_delta({"--name", value});
+            if (value != name.value() || std::string("kept") != kept.value()) {
+                std::cout << "[FAIL] Unexpected C-string value after change " << idelta << std::endl;
+                ++num_failed;
+                break;
+            }
+            if (idelta == 100) {
+                bytes_in_use = counting.bytes_in_use;
+            }
+        }
+        if (counting.bytes_in_use > bytes_in_use + 4096) {
+            std::cout << "[FAIL] Memory in use grew from " << bytes_in_use << " to " << counting.bytes_in_use
+                      << " bytes over repeated changes" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Memory in use stayed bounded over repeated changes" << std::endl;
+        }
+    }
+
+    //Interned strings keep their ids (and addresses) as the intern table grows
+    {
+        std::vector<argparse::StringId> ids;
+        std::vector<const std::string*> addresses;
+        for (size_t istr = 0; istr < 10000; ++istr) {
+            ids.push_back(argparse::intern_string("interned" + std::to_string(istr)));
+            addresses.push_back(&argparse::interned_string(ids.back()));
+        }
+        bool interned_ok = true;
+        for (size_t istr = 0; istr < ids.size(); ++istr) {
+            std::string str = "interned" + std::to_string(istr);
+            if (argparse::intern_string(str) != ids[istr] || &argparse::interned_string(ids[istr]) != addresses[istr]
+                || argparse::interned_string(ids[istr]) != str) {
+                interned_ok = false;
+            }
+        }
+        if (!interned_ok || !argparse::interned_string(argparse::EMPTY_STRING_ID).empty()) {
+            std::cout << "[FAIL] Unexpected interned strings" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Interned strings kept their ids" << std::endl;
+        }
+    }
+
+    //Parsers allocate their internal storage from the memory resource they are given
+    {
+        CountingResource counting;
+        {
+            argparse::UnsynchronizedPoolResource pool(&counting);
+            ArgValue<int> count;
+            ArgValue<std::vector<std::string>> files;
+            ArgValue<std::string> output;
+            ArgValue<bool> flag;
+            argparse::ArgumentParser pool_parser("pool", "", &pool);
+            pool_parser.add_argument(count, "--count", "-c");
+            pool_parser.add_argument(output, "output");
+            pool_parser.add_argument(files, "--files").nargs('+');
+            pool_parser.add_argument(flag, "--flag", "-f").action(argparse::Action::STORE_TRUE);
+
+            pool_parser.parse_args_throw({"out", "-f", "--count", "3", "--files", "a", "b"});
+            size_t num_allocations = counting.num_allocations;
+            if (num_allocations == 0 || pool_parser.memory_resource() != &pool) {
+                std::cout << "[FAIL] Parser did not allocate from its memory resource" << std::endl;
+                ++num_failed;
+            }
+
+            //Once warm, re-parsing is served entirely from the pool
+            for (size_t iparse = 0; iparse < 100; ++iparse) {
+                pool_parser.parse_args_throw({"out", "-f", "--count", std::to_string(iparse), "--files", "a", "b"});
+            }
+            if (counting.num_allocations != num_allocations || count != 99 || !flag || files.value().size() != 2 || output.value() != "out") {
+                std::cout << "[FAIL] Re-parsing allocated from upstream resource ("
+                          << counting.num_allocations - num_allocations << " allocations)" << std::endl;
+                ++num_failed;
+            }
+
+            //The groups are also available as a (global heap) copy
+            std::vector<argparse::ArgumentGroup> groups = pool_parser.argument_groups();
+            if (groups.size() != pool_parser.argument_groups_view().size() || groups[0].arguments().size() != 5) {
+                std::cout << "[FAIL] Unexpected copy of argument groups" << std::endl;
+                ++num_failed;
+            }
+        }
+        if (counting.bytes_in_use != 0) {
+            std::cout << "[FAIL] Memory resource leaked " << counting.bytes_in_use << " bytes" << std::endl;
+            ++num_failed;
+        }
+
+        //A one-shot parse backed by a buffer on the stack
+        size_t upstream_allocations = counting.num_allocations;
+        alignas(std::max_align_t) char buffer[16384];
+        argparse::MonotonicBufferResource monotonic(buffer, sizeof(buffer), &counting);
+        ArgValue<const char*> name;
+        argparse::ArgumentParser stack_parser("stack", "", &monotonic);
+        stack_parser.add_argument(name, "--name");
+        stack_parser.parse_args_throw({"--name", "stack"});
+        if (std::string("stack") != name.value() || counting.num_allocations != upstream_allocations) {
+            std::cout << "[FAIL] Stack buffer parse used upstream resource" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //Help can be rendered into a re-used string or written directly to a file descriptor
+    {
+        std::string help;
+        argparse::StringSink string_sink(help);
+        parser.print_help(string_sink);
+
+        argparse::DefaultFormatter formatter;
+        formatter.set_parser(&parser);
+        std::string formatted = formatter.format_usage() + formatter.format_description()
+                              + formatter.format_arguments() + formatter.format_epilog();
+        if (help != formatted || help.size() < 4096) {
+            std::cout << "[FAIL] Help written to a string sink differs from the formatted help" << std::endl;
+            ++num_failed;
+        }
+
+#ifndef _WIN32
+        std::FILE* file = std::tmpfile();
+        {
+            argparse::FdSink fd_sink(fileno(file));
+            parser.print_help(fd_sink);
+            parser.print_usage(fd_sink);
+        }
+        std::string expected = help + formatter.format_usage();
+        std::vector<char> written(expected.size() + 1); //Room to detect extra output
+        std::rewind(file);
+        size_t num_read = std::fread(written.data(), 1, written.size(), file);
+        std::fclose(file);
+        if (std::string(written.data(), num_read) != expected) {
+            std::cout << "[FAIL] Help written to a file descriptor differs from the formatted help" << std::endl;
+            ++num_failed;
+        }
+#endif
+    }
+
+    //Pre-rendered help is only served while it matches the parser's definition
+    {
+        std::string formatted;
+        argparse::StringSink formatted_sink(formatted);
+        parser.print_help(formatted_sink);
+
+        argparse::PrerenderedHelp prerendered = {parser.schema_json_hash(), "usage: pre\n", "pre-rendered help\n", "", ""};
+        parser.prerendered_help(&prerendered);
+
+        std::string help;
+        argparse::StringSink help_sink(help);
+        parser.print_help(help_sink);
+        parser.print_usage(help_sink);
+        if (help != "pre-rendered help\nusage: pre\n") {
+            std::cout << "[FAIL] Matching pre-rendered help was not used" << std::endl;
+            ++num_failed;
+        }
+
+        prerendered.schema_json_hash += 1;
+        help.clear();
+        parser.print_help(help_sink);
+        if (help != formatted) {
+            std::cout << "[FAIL] Stale pre-rendered help was used" << std::endl;
+            ++num_failed;
+        }
+        parser.prerendered_help(nullptr);
+
+        std::stringstream source;
+        parser.write_prerendered_help(source, "test_help");
+        std::string source_str = source.str();
+        std::stringstream hash_str;
+        hash_str << parser.schema_json_hash() << "ULL";
+        if (source_str.find("const argparse::PrerenderedHelp test_help = {") == std::string::npos
+            || source_str.find(hash_str.str()) == std::string::npos
+            || source_str.find("\"usage: argparse_test") == std::string::npos
+            || source_str.find("\\\"") == std::string::npos) { //Quotes in the help are escaped
+            std::cout << "[FAIL] Unexpected pre-rendered help source" << std::endl;
+            ++num_failed;
+        }
+
+        std::string man_page;
+        argparse::StringSink man_page_sink(man_page);
+        parser.write_man_page(man_page_sink);
+        if (man_page.find(".TH \"ARGPARSE_TEST\" 1\n") != 0 || man_page.find(".SH SYNOPSIS\n.nf\nargparse_test ") == std::string::npos
+            || man_page.find("\\fB\\-h, \\-\\-help\\fR") == std::string::npos) {
+            std::cout << "[FAIL] Unexpected man page" << std::endl;
+            ++num_failed;
+        }
+
+        std::string markdown;
+        argparse::StringSink markdown_sink(markdown);
+        parser.write_markdown(markdown_sink);
+        if (markdown.find("# argparse\\_test\n") != 0 || markdown.find("```\nusage: argparse_test ") == std::string::npos
+            || markdown.find("- `-h, --help`: ") == std::string::npos) {
+            std::cout << "[FAIL] Unexpected markdown" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //Constraints between the stage options
+    {
+        ArgValue<bool> pack, place, route, analysis;
+        std::deque<ArgValue<bool>> fillers; //Place some options beyond the first bitset word
+        argparse::ArgumentParser stage_parser("stages");
+        for (size_t i = 0; i < 70; ++i) {
+            fillers.emplace_back();
+            stage_parser.add_argument(fillers.back(), "--filler" + std::to_string(i)).action(argparse::Action::STORE_TRUE);
+        }
+        stage_parser.add_argument(pack, "--pack").action(argparse::Action::STORE_TRUE);
+        stage_parser.add_argument(place, "--place").action(argparse::Action::STORE_TRUE);
+        stage_parser.add_argument(route, "--route").action(argparse::Action::STORE_TRUE);
+        stage_parser.add_argument(analysis, "--analysis").action(argparse::Action::STORE_TRUE);
+
+        stage_parser.at_least_one_of({"--pack", "--place", "--route", "--analysis"})
+            .mutually_exclusive({"--filler0", "--analysis"})
+            .if_specified_requires("--route", {"--place", "--pack"})
+            .if_specified_conflicts("--filler69", {"--pack", "--place"});
+
+        std::vector<std::vector<std::string>> stage_pass_cases = {
+            {"--pack"},
+            {"--analysis", "--filler69"},
+            {"--pack", "--place", "--route", "--analysis"},
+            {"--filler0", "--pack"},
+        };
+        for (const auto& cmd_line : stage_pass_cases) {
+            if (!expect_pass(stage_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        std::vector<std::vector<std::string>> stage_fail_cases = {
+            {},                                     //None of the stages
+            {"--filler1"},                          //None of the stages
+            {"--filler0", "--analysis"},            //Mutually exclusive
+            {"--route", "--pack"},                  //Missing --place
+            {"--route"},                            //Missing --place and --pack
+            {"--filler69", "--analysis", "--place"} //Conflicting
+        };
+        for (const auto& cmd_line : stage_fail_cases) {
+            if (!expect_fail(stage_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        //Constraints are re-checked after a delta
+        stage_parser.parse_args_throw({"--pack", "--place", "--route"});
+        if (!expect_fail_delta(stage_parser, {}, {"--place"})) {
+            ++num_failed;
+        }
+        stage_parser.reset_destinations();
+
+        bool rejected = false;
+        try {
+            stage_parser.mutually_exclusive({"--pack"});
+        } catch (const argparse::ArgParseError&) {
+            rejected = true;
+        }
+        if (!rejected) {
+            std::cout << "[FAIL] Mutually exclusive constraint with a single option accepted" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //Options taking a fixed number of values
+    {
+        ArgValue<std::array<float,4>> bbox;
+        ArgValue<std::tuple<int,float,std::string>> tile;
+        ArgValue<std::vector<int>> triple;
+        argparse::ArgumentParser fixed_parser("fixed");
+        auto& bbox_arg = fixed_parser.add_argument(bbox, "--bbox")
+            .metavar("COORD")
+            .default_value({"0", "0", "1", "1"});
+        fixed_parser.add_argument(tile, "--tile");
+        fixed_parser.add_argument(triple, "--triple").nargs(3);
+
+        try {
+            fixed_parser.parse_args_throw({"--bbox", "0.5", "0", "1.5", "2", "--tile", "3", "0.25", "clb"});
+            if (bbox.value() != std::array<float,4>{{0.5, 0, 1.5, 2}}
+                || tile.value() != std::make_tuple(3, 0.25f, std::string("clb"))) {
+                std::cout << "[FAIL] Unexpected fixed arity values" << std::endl;
+                ++num_failed;
+            }
+
+            fixed_parser.parse_args_throw({"--triple", "1", "2", "3", "--bbox=4", "5", "6", "7"});
+            if (bbox.value() != std::array<float,4>{{4, 5, 6, 7}}
+                || triple.value() != std::vector<int>{1, 2, 3}
+                || tile.provenance() != argparse::Provenance::UNSPECIFIED) {
+                std::cout << "[FAIL] Unexpected fixed arity values with an attached value" << std::endl;
+                ++num_failed;
+            }
+
+            fixed_parser.parse_args_throw({});
+            if (bbox.value() != std::array<float,4>{{0, 0, 1, 1}} || bbox.provenance() != argparse::Provenance::DEFAULT) {
+                std::cout << "[FAIL] Unexpected fixed arity default" << std::endl;
+                ++num_failed;
+            } else {
+                std::cout << "[PASS] Fixed arity values stored" << std::endl;
+            }
+            fixed_parser.reset_destinations();
+        } catch (const argparse::ArgParseError& e) {
+            std::cout << "[FAIL] " << e.what() << std::endl;
+            ++num_failed;
+        }
+
+        std::vector<std::vector<std::string>> fixed_fail_cases = {
+            {"--bbox", "0", "1", "2"},                      //Too few values
+            {"--bbox", "0", "1", "2", "--tile", "1", "2", "a"}, //Too few values before the next option
+            {"--bbox", "0", "1", "2", "3", "4"},            //Too many values
+            {"--bbox", "0", "1", "2", "x"},                 //Malformed value
+            {"--tile", "1.5", "2", "a"},                    //Malformed value (for its element)
+            {"--bbox", "0", "1", "2", "3", "--bbox", "0", "1", "2", "3"}, //Repeated
+            {"--triple", "1", "2"},                         //Too few values
+        };
+        for (const auto& cmd_line : fixed_fail_cases) {
+            if (!expect_fail(fixed_parser, cmd_line)) {
+                ++num_failed;
+            }
+        }
+
+        std::vector<std::function<void()>> invalid_setups = {
+            [&]() { bbox_arg.nargs(3); },
+            [&]() { bbox_arg.nargs('+'); },
+            [&]() { bbox_arg.default_value({"0", "1"}); },
+        };
+        for (const auto& setup : invalid_setups) {
+            bool rejected = false;
+            try {
+                setup();
+            } catch (const argparse::ArgParseError&) {
+                rejected = true;
+            }
+            if (!rejected) {
+                std::cout << "[FAIL] Fixed arity option accepted an inconsistent definition" << std::endl;
+                ++num_failed;
+            }
+        }
+
+        std::string help;
+        argparse::StringSink help_sink(help);
+        fixed_parser.print_help(help_sink);
+        if (help.find("--bbox COORD COORD COORD COORD") == std::string::npos) {
+            std::cout << "[FAIL] Fixed arity metavars missing from help:\n" << help << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Fixed arity metavars shown in help" << std::endl;
+        }
+    }
+
+#ifndef _WIN32
+    //Command-lines streamed from a file descriptor
+    {
+        ArgValue<int> jobs;
+        ArgValue<std::vector<std::string>> files;
+        argparse::ArgumentParser stream_parser("stream");
+        stream_parser.add_argument(jobs, "--jobs", "-j").default_value("1");
+        stream_parser.add_argument(files, "--files").nargs('*');
+
+        //Arguments may span chunks, and the final command-line need not be terminated
+        std::string input;
+        auto add_arg = [&](const std::string& arg) {
+            input += arg;
+            input += '\0';
+        };
+        add_arg("-j"); add_arg("4"); input += '\n';
+        input += '\n';
+        add_arg("--files"); add_arg(std::string(100, 'f')); add_arg("li\nne"); input += '\n';
+        add_arg("--jobs"); add_arg("x"); input += '\n';
+        add_arg("-j"); input += "2";
+        std::vector<std::string> expected = {"4 0", "1 0", "1 2", "error", "2 0"};
+
+        std::FILE* file = std::tmpfile();
+        std::fwrite(input.data(), 1, input.size(), file);
+        std::fflush(file);
+
+        for (size_t chunk_size : {1, 7, 4096}) {
+            std::rewind(file);
+            std::vector<std::string> results;
+            auto stats = stream_parser.parse_stream(fileno(file), [&](size_t record_index, const argparse::ArgParseError* error) {
+                if (record_index != results.size()) {
+                    results.push_back("out of order");
+                } else if (error) {
+                    results.push_back("error");
+                } else {
+                    results.push_back(std::to_string(jobs.value()) + " " + std::to_string(files.value().size()));
+                }
+            }, chunk_size);
+
+            if (results != expected || stats.num_records != 5 || stats.num_failed != 1 || stats.num_bytes != input.size()) {
+                std::cout << "[FAIL] Unexpected streamed parse results (chunk size " << chunk_size << "): " << argparse::join(results, ", ") << std::endl;
+                ++num_failed;
+            } else {
+                std::cout << "[PASS] Streamed command-lines parsed (chunk size " << chunk_size << ")" << std::endl;
+            }
+        }
+        std::fclose(file);
+    }
+#endif
+
+#ifdef ARGPARSE_TEST_SERVER
+    //Command-lines validated by a server, concurrently for several clients
+    {
+        std::string socket_path = "/tmp/argparse_test." + std::to_string(::getpid()) + ".sock";
+        argparse::ValidationServer server(socket_path, []() { return std::make_shared<JobsParser>(); }, 2);
+        std::thread server_thread([&]() { server.serve(); });
+
+        struct ValidationCase {
+            std::vector<std::string> args;
+            bool valid;
+        };
+        std::vector<ValidationCase> validation_cases = {
+            {{"-j", "4", "--files", "a", "b"}, true},
+            {{}, true},
+            {{"--jobs", "x"}, false},
+            {{"--files", std::string(100000, 'f')}, true}, //Spans several reads
+            {{"--help"}, false},
+            {{"--no_such_option"}, false},
+        };
+        const size_t num_clients = 4;
+        const size_t num_reps = 50;
+
+        std::vector<size_t> client_failures(num_clients, 0);
+        std::vector<std::thread> clients;
+        for (size_t iclient = 0; iclient < num_clients; ++iclient) {
+            clients.emplace_back([&, iclient]() {
+                try {
+                    argparse::ValidationClient client(socket_path);
+                    for (size_t irep = 0; irep < num_reps; ++irep) {
+                        for (const auto& validation_case : validation_cases) {
+                            std::string error;
+                            bool valid = client.validate(validation_case.args, &error);
+                            if (valid != validation_case.valid || valid != error.empty()) {
+                                ++client_failures[iclient];
+                            }
+                        }
+                    }
+                } catch (const argparse::ArgParseError&) {
+                    ++client_failures[iclient];
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        server.stop();
+        server_thread.join();
+
+        size_t num_client_failures = std::accumulate(client_failures.begin(), client_failures.end(), size_t(0));
+        if (num_client_failures > 0 || server.num_requests() != num_clients * num_reps * validation_cases.size()) {
+            std::cout << "[FAIL] Unexpected validation server results (" << num_client_failures << " failures, "
+                      << server.num_requests() << " requests)" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Validation server answered " << server.num_requests() << " requests" << std::endl;
+        }
+    }
+
+    //Validation server drops clients which send oversized frames, and is not held up by clients which stop reading
+    {
+        std::string socket_path = "/tmp/argparse_test." + std::to_string(::getpid()) + ".stall.sock";
+        argparse::ValidationServer server(socket_path, []() { return std::make_shared<JobsParser>(); }, 1);
+        std::thread server_thread([&]() { server.serve(); });
+
+        auto connect_raw = [&]() {
+            sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+            return fd;
+        };
+
+        //The oversized header is rejected without waiting for its payload
+        int oversized_fd = connect_raw();
+        uint32_t oversized_size = argparse::MAX_VALIDATION_FRAME_SIZE + 1;
+        char byte;
+        bool oversized_dropped = oversized_fd >= 0
+                                 && ::write(oversized_fd, &oversized_size, sizeof(oversized_size)) == sizeof(oversized_size)
+                                 && ::read(oversized_fd, &byte, 1) == 0;
+        if (oversized_fd >= 0) ::close(oversized_fd);
+
+        //Send requests (with long error responses) without reading, until the server stops accepting them
+        int stalled_fd = connect_raw();
+        std::string request(sizeof(uint32_t), '\0');
+        request += "--no_such_option";
+        request += '\0';
+        uint32_t payload_size = request.size() - sizeof(uint32_t);
+        std::memcpy(&request[0], &payload_size, sizeof(payload_size));
+        bool stalled = false;
+        size_t request_pos = 0;
+        for (size_t isend = 0; stalled_fd >= 0 && isend < 1000000 && !stalled; ++isend) {
+            ssize_t num_sent = ::send(stalled_fd, request.data() + request_pos, request.size() - request_pos, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (num_sent < 0) {
+                pollfd poll_fd = {stalled_fd, POLLOUT, 0};
+                stalled = (::poll(&poll_fd, 1, 200) == 0);
+            } else {
+                request_pos = (request_pos + num_sent) % request.size();
+            }
+        }
+
+        auto stop_start = std::chrono::steady_clock::now();
+        server.stop();
+        server_thread.join();
+        std::chrono::duration<double> stop_time = std::chrono::steady_clock::now() - stop_start;
+        if (stalled_fd >= 0) ::close(stalled_fd);
+
+        if (!oversized_dropped || !stalled || stop_time.count() > 1.) {
+            std::cout << "[FAIL] Unexpected validation server handling of misbehaving clients (oversized frame "
+                      << (oversized_dropped ? "" : "not ") << "dropped, " << (stalled ? "" : "not ") << "stalled, stopped in "
+                      << stop_time.count() << " s)" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Validation server dropped misbehaving clients" << std::endl;
+        }
+    }
+#endif
+
+    //Subcommands, whose parsers should only be constructed when selected
+    ArgValue<std::string> command;
+    ArgValue<float> pack_alpha;
+    ArgValue<size_t> route_chan_width;
+    int num_pack_parsers = 0;
+    int num_route_parsers = 0;
+
+    auto sub_parser = argparse::ArgumentParser("vpr", "Test parser for subcommands");
+    sub_parser.add_subparsers(command)
+        .required(true)
+        .add_parser("pack", [&](argparse::ArgumentParser& pack_parser) {
+                ++num_pack_parsers;
+                pack_parser.add_argument(pack_alpha, "--alpha")
+                    .default_value("0.75");
+            }, "Run packing")
+        .add_parser("route", [&](argparse::ArgumentParser& route_parser) {
+                ++num_route_parsers;
+                route_parser.add_argument(route_chan_width, "--route_chan_width")
+                    .required(true);
+            }, "Run routing");
+
+    sub_parser.print_help();
+    std::cout << "\n";
+
+    std::vector<std::vector<std::string>> subcommand_pass_cases = {
+        {"pack"},
+        {"pack", "--alpha", "0.5"},
+    };
+    for(const auto& cmd_line : subcommand_pass_cases) {
+        if(!expect_pass(sub_parser, cmd_line)) {
+            std::cout << "       Failed to parse: '" << argparse::join(cmd_line, " ") << "'" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    std::vector<std::vector<std::string>> subcommand_fail_cases = {
+        {}, //Missing subcommand
+        {"place"}, //Unknown subcommand
+        {"pack", "--route_chan_width", "100"}, //Option of another subcommand
+        {"--alpha", "0.5", "pack"}, //Subcommand option before subcommand
+    };
+    for(const auto& cmd_line : subcommand_fail_cases) {
+        if(!expect_fail(sub_parser, cmd_line)) {
+            std::cout << "       Parsed successfully when expected failure: '" << argparse::join(cmd_line, " ") << "'" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    if (num_pack_parsers != 1 || num_route_parsers != 0) {
+        std::cout << "[FAIL] Expected only the pack parser to be constructed once" << std::endl;
+        ++num_failed;
+    }
+
+    if (!expect_pass(sub_parser, {"route", "--route_chan_width", "100"})
+        || !expect_fail(sub_parser, {"route"})) { //Missing required subcommand option
+        ++num_failed;
+    }
+
+    //Re-parsing without a subcommand should clear the previous subcommand and its values
+    ArgValue<std::string> reuse_command;
+    ArgValue<bool> reuse_verbose;
+    ArgValue<float> reuse_alpha;
+    auto reuse_parser = argparse::ArgumentParser("vpr", "Test parser for re-parsing subcommands");
+    reuse_parser.add_argument<bool,OnOff>(reuse_verbose, "--verbose")
+        .action(argparse::Action::STORE_TRUE)
+        .default_value("off");
+    reuse_parser.add_subparsers(reuse_command)
+        .add_parser("pack", [&](argparse::ArgumentParser& pack_parser) {
+                pack_parser.add_argument(reuse_alpha, "--alpha")
+                    .default_value("0.75");
+            }, "Run packing");
+    try {
+        reuse_parser.parse_args_throw({"pack", "--alpha", "0.5"});
+        bool first_ok = reuse_command.provenance() == argparse::Provenance::SPECIFIED
+                        && reuse_alpha.provenance() == argparse::Provenance::SPECIFIED;
+
+        reuse_parser.parse_args_throw({"--verbose"});
+        if (!first_ok
+            || reuse_command.provenance() == argparse::Provenance::SPECIFIED
+            || reuse_alpha.provenance() == argparse::Provenance::SPECIFIED
+            || !reuse_verbose.value()) {
+            std::cout << "[FAIL] Re-parse without a subcommand kept the previous subcommand's values" << std::endl;
+            ++num_failed;
+        } else {
+            std::cout << "[PASS] Re-parse without a subcommand cleared the previous subcommand's values" << std::endl;
+        }
+    } catch (const argparse::ArgParseError& e) {
+        std::cout << "[FAIL] Re-parsing subcommands: " << e.what() << std::endl;
+        ++num_failed;
+    }
+    reuse_parser.reset_destinations();
+
+    struct CompletionCase {
+        std::vector<std::string> cmd_line;
+        size_t cursor;
+        std::vector<std::string> expected;
+    };
+    std::vector<CompletionCase> completion_cases = {
+        {{"my_arch.xml", "my_circuit.blif", "--route_chan"}, 2, {"--route_chan_width"}}, //Unique option
+        {{"my_arch.xml", "my_circuit.blif", "--pla"}, 2, {"--place", "--place_algorithm", "--place_chan_width", "--place_file"}}, //Multiple options
+        {{"--slack_definition"}, 1, {"R", "I", "S", "G", "C", "N"}}, //Choices of option value
+        {{"--disp", "o"}, 1, {"on", "off"}}, //Choices of option value (from converter)
+        {{"--slack_definition="}, 0, {"--slack_definition=R", "--slack_definition=I", "--slack_definition=S",
+                                      "--slack_definition=G", "--slack_definition=C", "--slack_definition=N"}}, //Attached value
+        {{"--disp", "on", "my_arch.xml"}, 2, {}}, //Free-form positional
+        {{"-j"}, 1, {}}, //Free-form option value
+        {{"--one_or_more", "1", "--ze"}, 2, {"--zero_or_more"}}, //Option after nargs='+' values
+    };
+
+    for(const auto& completion_case : completion_cases) {
+        bool pass = expect_completions(parser, completion_case.cmd_line, completion_case.cursor, completion_case.expected);
+
+        if(!pass) {
+            std::cout << "       Unexpected completions for: '" << argparse::join(completion_case.cmd_line, " ") << "'" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    std::vector<CompletionCase> subcommand_completion_cases = {
+        {{""}, 0, {"pack", "route"}}, //Subcommand names
+        {{"route", "--route"}, 1, {"--route_chan_width"}}, //Subcommand options
+    };
+    for(const auto& completion_case : subcommand_completion_cases) {
+        bool pass = expect_completions(sub_parser, completion_case.cmd_line, completion_case.cursor, completion_case.expected);
+
+        if(!pass) {
+            std::cout << "       Unexpected completions for: '" << argparse::join(completion_case.cmd_line, " ") << "'" << std::endl;
+            ++num_failed;
+        }
+    }
+
+    //Completion scripts quote the program name and cache file, and embed (for bash and zsh)
+    //the options and choices of each parser
+    {
+        argparse::ArgumentParser quoted_parser("my tool's");
+        std::string cache_file = "/tmp/a b/it's\\.cache";
+        struct ScriptCase {
+            argparse::ArgumentParser* parser;
+            argparse::CompletionShell shell;
+            std::vector<std::string> expected;
+        };
+        std::vector<ScriptCase> script_cases = {
+            {&quoted_parser, argparse::CompletionShell::BASH, {"complete -F _argparse_my_tool_s 'my tool'\\''s'\n"}},
+            {&quoted_parser, argparse::CompletionShell::FISH, {"complete -c 'my tool'\\''s' -e\n",
+                                                               "if test -r '/tmp/a b/it'\\''s\\\\.cache'\n",
+                                                               " -d \"$fields[4]\"\n"}},
+            {&sub_parser, argparse::CompletionShell::BASH, {"'pack') _argparse_vpr_words_pack $(( i + 1 )); return ;;\n",
+                                                            "0) COMPREPLY=( $(compgen -W 'pack route' -- \"$cur\") ) ;;\n",
+                                                            "compgen -W '--alpha --help -h' -- \"$cur\""}},
+            {&sub_parser, argparse::CompletionShell::FISH, {"complete -c 'vpr' -f -n __fish_use_subcommand -a 'pack' -d 'Run packing'\n"}},
+        };
+        for (const auto& script_case : script_cases) {
+            std::string script = script_case.parser->completion_script(script_case.shell, cache_file);
+            for (const auto& expected : script_case.expected) {
+                if (script.find(expected) == std::string::npos) {
+                    std::cout << "[FAIL] Completion script missing '" << expected << "':\n" << script << std::endl;
+                    ++num_failed;
+                }
+            }
+        }
+    }
+
     if (num_failed != 0) {
         std::cout << "\n";
         std::cout << "FAILED: " << num_failed << " test(s)!" << "\n";
@@ -578,3 +1794,24 @@ bool expect_fail(argparse::ArgumentParser& parser, std::vector<std::string> cmd_
     parser.reset_destinations();
     return false;
 }
+
+bool expect_completions(argparse::ArgumentParser& parser, std::vector<std::string> cmd_line, size_t cursor, std::vector<std::string> expected) {
+    auto completions = parser.complete(cmd_line, cursor);
+    if (completions != expected) {
+        std::cout << "[FAIL] Completed to '" << argparse::join(completions, " ") << "' expected '" << argparse::join(expected, " ") << "'" << std::endl;
+        return false;
+    }
+    std::cout << "[PASS] Completed to '" << argparse::join(completions, " ") << "'" << std::endl;
+    return true;
+}
+
+bool expect_fail_delta(argparse::ArgumentParser& parser, std::vector<std::string> changed_args, std::vector<std::string> removed_options) {
+    try {
+        parser.parse_args_delta(changed_args, removed_options);
+    } catch(const argparse::ArgParseError& err) {
+        std::cout << "[PASS] " << err.what() << std::endl;
+        return true;
+    }
+    std::cout << "[FAIL] Applied changes OK when expected fail" << std::endl;
+    return false;
+}
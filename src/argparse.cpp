@@ -2,6 +2,8 @@
 #include <array>
 #include <list>
 #include <cassert>
+#include <iostream>
+#include <limits>
 #include <string>
 #include <set>
 
@@ -15,13 +17,31 @@ namespace argparse {
      * ArgumentParser
      */
 
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str)
+        : ArgumentParser(prog_name, description_str, new_delete_resource(), std::cout)
+        {}
+
     ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, std::ostream& os)
-        : description_(description_str)
-        , formatter_(new DefaultFormatter())
+        : ArgumentParser(prog_name, description_str, new_delete_resource(), os)
+        {}
+
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, MemoryResource* resource)
+        : ArgumentParser(prog_name, description_str, resource, std::cout)
+        {}
+
+    ArgumentParser::ArgumentParser(std::string prog_name, std::string description_str, MemoryResource* resource, std::ostream& os)
+        : memory_resource_(resource)
+        , description_(description_str)
+        , argument_groups_(resource)
+        , option_index_(resource)
+        , arguments_(resource)
+        , string_arena_(resource)
+        , scratch_arena_(resource)
+        , argument_indices_(resource)
         , os_(os)
         {
         prog(prog_name);
-        argument_groups_.push_back(ArgumentGroup("arguments"));
+        argument_groups_.push_back(ArgumentGroup("arguments", resource));
     }
 
     ArgumentParser& ArgumentParser::prog(std::string prog_name, bool basename_only) {
@@ -43,27 +63,45 @@ namespace argparse {
         return *this;
     }
 
+    ArgumentParser& ArgumentParser::allow_abbrev(bool allow) {
+        allow_abbrev_ = allow;
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::prerendered_help(const PrerenderedHelp* help) {
+        prerendered_help_ = help;
+        return *this;
+    }
+
     ArgumentGroup& ArgumentParser::add_argument_group(std::string description_str) {
-        argument_groups_.push_back(ArgumentGroup(description_str));
+        argument_groups_.push_back(ArgumentGroup(description_str, memory_resource_));
         return argument_groups_[argument_groups_.size() - 1];
     }
 
+    Subparsers& ArgumentParser::add_subparsers(ArgValue<std::string>& dest, std::string title) {
+        if (subparsers_) {
+            throw ArgParseError("Subcommands can only be added once");
+        }
+        subparsers_.reset(new Subparsers(dest, title));
+        return *subparsers_;
+    }
+
     void ArgumentParser::parse_args(int argc, const char* const* argv, int error_exit_code, int help_exit_code, int version_exit_code) {
         try {
             parse_args_throw(argc, argv);
         } catch (const argparse::ArgParseHelp&) {
             //Help requested
-            print_help();
+            innermost_active_parser().print_help();
             std::exit(help_exit_code);
         } catch (const argparse::ArgParseVersion&) {
-            print_version();
+            innermost_active_parser().print_version();
             std::exit(version_exit_code);
         } catch (const argparse::ArgParseError& e) {
             //Failed to parse
             std::cout << e.what() << "\n";
 
             std::cout << "\n";
-            print_usage();
+            innermost_active_parser().print_usage();
             std::exit(error_exit_code);
         }
     }
@@ -77,75 +115,197 @@ namespace argparse {
         parse_args_throw(arg_strs);
     }
     
-    void ArgumentParser::parse_args_throw(std::vector<std::string> arg_strs) {
+    void ArgumentParser::parse_args_throw(const std::vector<std::string>& arg_strs) {
+        //Neither the previous subcommand, nor the values parsed by its parser, may outlive this parse
+        reset_subcommands();
+        parsed_ = false;
         add_help_option_if_unspecified();
+        update_option_index();
+
+        //C-string values from the previous parse are all replaced below, so their storage can be re-used
+        string_arena_.reset();
+        StringArenaScope arena_scope(&string_arena_);
 
         //Reset all the defaults
-        for (const auto& group : argument_groups()) {
-            for (const auto& arg : group.arguments()) {
-                if (arg->default_set()) {
+        for (const auto& arg : arguments_) {
+            if (arg->default_set()) {
+                //Defaults are pre-converted, and need not be re-applied if left untouched by the previous parse
+                if (!arg->dest_holds_default()) {
                     arg->set_dest_to_default();
                 }
+            } else if (arg->dest_provenance() != Provenance::UNSPECIFIED) {
+                //Clear the value set by (or since) the previous parse
+                arg->reset_dest();
             }
         }
+        specified_.resize(arguments_.size());
 
-        //Create a look-up of expected argument strings and positional arguments
-        std::map<std::string,std::shared_ptr<Argument>> str_to_option_arg;
-        std::list<std::shared_ptr<Argument>> positional_args;
-        for (const auto& group : argument_groups()) {
-            for (const auto& arg : group.arguments()) {
-                if (arg->positional()) {
-                    positional_args.push_back(arg);
-                } else {
-                    for (const auto& opt : {arg->long_option(), arg->short_option()}) {
-                        if (opt.empty()) continue;
+        //Collect the positional arguments
+        PmrList<std::shared_ptr<Argument>> positional_args(memory_resource_);
+        for (const auto& arg : arguments_) {
+            if (arg->positional()) {
+                positional_args.push_back(arg);
+            }
+        }
 
-                        auto ret = str_to_option_arg.insert(std::make_pair(opt, arg));
+        size_t subcommand_idx = parse_arg_strs(arg_strs, positional_args, true);
 
-                        if (!ret.second) {
-                            //Option string already specified
-                            std::stringstream ss;
-                            ss << "Option string '" << opt << "' maps to multiple options";
-                            throw ArgParseError(ss.str());
-                        }
-                    }
-                }
+        //Missing positionals?
+        for(const auto& remaining_positional : positional_args) {
+            std::stringstream ss;
+            ss << "Missing required positional argument: " << remaining_positional->long_option();
+            throw ArgParseError(ss.str());
+        }
+
+        //Missing required?
+        check_required(arguments_);
+        check_constraints();
+
+        if (subparsers_) {
+            if (subcommand_idx < arg_strs.size()) {
+                parse_subcommand(arg_strs[subcommand_idx],
+                                 std::vector<std::string>(arg_strs.begin() + subcommand_idx + 1, arg_strs.end()));
+            } else if (subparsers_->required()) {
+                std::stringstream msg;
+                msg << "Missing required subcommand (expected one of: " << join(subparsers_->names(), ", ") << ")";
+                throw ArgParseError(msg.str());
             }
         }
+        parsed_ = true;
+        live_arena_size_ = string_arena_.size();
 
-        std::set<std::shared_ptr<Argument>> specified_arguments;
+        update_changes(arguments_);
+    }
 
-        //Process the arguments
-        for (size_t i = 0; i < arg_strs.size(); i++) {
-            ShortArgInfo short_arg_info = no_space_short_arg(arg_strs[i], str_to_option_arg);
+    std::vector<std::shared_ptr<Argument>> ArgumentParser::parse_args_delta(std::vector<std::string> changed_args, std::vector<std::string> removed_options) {
+        if (!parsed_) {
+            throw ArgParseError("Command-line changes can only be applied after a successful parse");
+        }
+        StringArenaScope arena_scope(&string_arena_);
+
+        //Determine the affected arguments
+        PmrVector<std::shared_ptr<Argument>> removed_args(memory_resource_);
+        for (const auto& opt : removed_options) {
+            auto arg = option_index_.find(StrRef(opt));
+            if (!arg) {
+                throw ArgParseError("Unexpected option to remove '" + opt + "'");
+            }
+            removed_args.push_back(arg);
+        }
 
-            std::shared_ptr<Argument> arg;
+        PmrVector<std::shared_ptr<Argument>> affected_args(memory_resource_);
+        auto add_affected = [&](const std::shared_ptr<Argument>& arg) {
+            //Deltas are small, so a linear search is cheap
+            if (std::find(affected_args.begin(), affected_args.end(), arg) == affected_args.end()) {
+                affected_args.push_back(arg);
+            }
+        };
+        for (const auto& arg : removed_args) {
+            add_affected(arg);
+        }
+        for (const auto& str : changed_args) {
+            OptionMatch match = match_option(str);
+            for (const auto& flag : match.packed_flags) {
+                add_affected(flag);
+            }
+            if (match.arg) {
+                add_affected(match.arg);
+            }
+        }
 
-            if (short_arg_info.is_no_space_short_arg) {
-                //Short argument with no space between value
-                arg = short_arg_info.arg;
-            } else { //Full argument
-                auto iter = str_to_option_arg.find(arg_strs[i]);
-                if (iter != str_to_option_arg.end()) {
-                    arg = iter->second;
-                }
+        parsed_ = false;
+
+        //Revert the affected arguments to their unspecified state
+        for (const auto& arg : affected_args) {
+            arg->snapshot_dest();
+
+            specified_.reset(argument_indices_[arg.get()]);
+            if (arg->default_set()) {
+                arg->set_dest_to_default();
+            } else {
+                arg->reset_dest();
             }
+        }
+
+        //Apply the changes. Only options may be changed, so there are no positional arguments to fill.
+        PmrList<std::shared_ptr<Argument>> no_positional_args(memory_resource_);
+        parse_arg_strs(changed_args, no_positional_args, false);
+
+        //Only removed arguments can have become missing
+        check_required(removed_args);
+        check_constraints();
+
+        //Replaced values are never reclaimed individually, but compacting once they outweigh
+        //the live values (plus a block, so small parses are not compacted repeatedly) keeps
+        //the cost of compaction proportional to the storage it reclaims
+        if (string_arena_.size() > 2 * live_arena_size_ + 4096) {
+            compact_string_arena();
+        }
+
+        parsed_ = true;
+
+        std::vector<std::shared_ptr<Argument>> changed;
+        for (const auto& arg : affected_args) {
+            if (arg->dest_changed()) {
+                changed.push_back(arg);
+            }
+        }
+
+        update_changes(affected_args);
+
+        return changed;
+    }
+
+    void ArgumentParser::compact_string_arena() {
+        //Copy out the destination values which may refer to the arena (i.e. excluding
+        //pre-converted defaults, and destinations last set by another argument)
+        std::string buf;
+        SnapshotWriter writer(buf);
+        PmrVector<Argument*> stored_args(memory_resource_);
+        for (const auto& arg : arguments_) {
+            if (arg->dest_provenance() == Provenance::UNSPECIFIED || arg->dest_holds_default() || !arg->dest_set_by_this()) {
+                continue;
+            }
+            arg->encode_dest(writer);
+            stored_args.push_back(arg.get());
+        }
+
+        string_arena_.reset();
+        StringArenaScope arena_scope(&string_arena_);
+        SnapshotReader reader(buf.data(), buf.size());
+        for (Argument* arg : stored_args) {
+            arg->decode_dest(reader, arg->dest_provenance());
+        }
+        live_arena_size_ = string_arena_.size();
+    }
+
+    size_t ArgumentParser::parse_arg_strs(const std::vector<std::string>& arg_strs, PmrList<std::shared_ptr<Argument>>& positional_args, bool allow_subcommand) {
+        //Process the arguments
+        for (size_t i = 0; i < arg_strs.size(); i++) {
+            OptionMatch match = match_option(arg_strs[i]);
+
+            std::shared_ptr<Argument> arg = match.arg;
 
             if (arg) {
                 //Start of an argument
 
-                specified_arguments.insert(arg);
-
-                if (arg->action() == Action::STORE_TRUE) {
-                    arg->set_dest_to_true(); 
-                } else if (arg->action() == Action::STORE_FALSE) {
-                    arg->set_dest_to_false();
-                } else if (arg->action() == Action::HELP) {
-                    arg->set_dest_to_true(); 
-                    throw ArgParseHelp();
-                } else if (arg->action() == Action::VERSION) {
-                    arg->set_dest_to_true(); 
-                    throw ArgParseVersion();
+                for (const auto& flag : match.packed_flags) {
+                    mark_specified(flag);
+                    apply_flag_action(*flag);
+                }
+
+                bool first_occurrence = mark_specified(arg);
+
+                if (match.has_attached_value && arg->nargs() == '0') {
+                    std::stringstream msg;
+                    msg << "Argument " << arg->name() << " does not accept a value (found '" << arg_strs[i] << "')";
+                    throw ArgParseError(msg.str());
+                }
+
+                if (arg->action() != Action::STORE) {
+                    apply_flag_action(*arg);
+                } else if (arg->nargs() == 'N') {
+                    i = parse_fixed_arity_values(*arg, match, arg_strs, i, first_occurrence);
                 } else {
                     assert(arg->action() == Action::STORE);
 
@@ -167,29 +327,30 @@ namespace argparse {
                         min_values_to_read = 1;
                     }
 
-                    std::vector<std::string> values;
-                    size_t nargs_read = 0;
-                    if (short_arg_info.is_no_space_short_arg) {
-                        //It is a short argument, we already have the first value
-                        if (!short_arg_info.value.empty()) {
-                            values.push_back(short_arg_info.value);
-                            ++nargs_read;
-                        }
+                    PmrVector<std::string> values(memory_resource_);
+                    if (match.has_attached_value) {
+                        //The first value was attached to the option string
+                        values.push_back(match.attached_value);
                     }
-                    for (; nargs_read < max_values_to_read; ++nargs_read) {
-                        size_t next_idx = i + 1 + nargs_read;
-                        if (next_idx >= arg_strs.size()) {
-                            break;
+                    size_t next_idx = i + 1;
+                    for (; values.size() < max_values_to_read && next_idx < arg_strs.size(); ++next_idx) {
+                        const std::string& str = arg_strs[next_idx];
+
+                        if (option_index_.is_option(str, allow_abbrev_)) break;
+
+                        //Validate in the scratch arena, so C-string values are only stored in
+                        //string_arena_ once (when converted for the destination)
+                        bool valid_value;
+                        {
+                            scratch_arena_.reset();
+                            StringArenaScope scratch_scope(&scratch_arena_);
+                            valid_value = arg->is_valid_value(str);
                         }
-                        std::string str = arg_strs[next_idx];
-
-
-                        if (is_argument(str, str_to_option_arg)) break;
-
-                        if (!arg->is_valid_value(str)) break;
+                        if (!valid_value) break;
 
                         values.push_back(str);
                     }
+                    size_t nargs_read = values.size();
 
                     if (nargs_read < min_values_to_read) {
 
@@ -225,6 +386,10 @@ namespace argparse {
                         assert(nargs_read == 1);
                         assert(values.size() == 1);
 
+                        if (!first_occurrence) {
+                            throw ArgParseError("Argument " + arg->name() + " specified multiple times");
+                        }
+
 
                         try {
                             arg->set_dest_to_value(values[0]); 
@@ -262,16 +427,32 @@ namespace argparse {
                         throw ArgParseError(msg.str());
                     }
 
-                    if (!short_arg_info.is_no_space_short_arg) {
-                        i += nargs_read; //Skip over the values (don't need to for short args)
-                    }
+                    i = next_idx - 1; //Skip over the values
+
                 }
 
             } else {
-                if (positional_args.empty()) {
+                if (positional_args.empty() && allow_subcommand && subparsers_ && arg_strs[i].compare(0, 1, "-") != 0) {
+                    //Subcommand, which handles all remaining arguments
+                    if (!subparsers_->find(arg_strs[i])) {
+                        std::stringstream ss;
+                        ss << "Unexpected subcommand '" << arg_strs[i] << "'";
+                        ss << " (expected one of: " << join(subparsers_->names(), ", ") << ")";
+                        throw ArgParseError(ss.str());
+                    }
+                    return i;
+                } else if (positional_args.empty()) {
                     //Unrecognized
                     std::stringstream ss;
                     ss << "Unexpected command-line argument '" << arg_strs[i] << "'";
+                    if (arg_strs[i].size() > 1 && arg_strs[i][0] == '-') {
+                        auto suggestions = option_index_.suggest(arg_strs[i]);
+                        if (suggestions.size() == 1) {
+                            ss << " (did you mean '" << suggestions[0] << "'?)";
+                        } else if (suggestions.size() > 1) {
+                            ss << " (did you mean one of '" << join(suggestions, "', '") << "'?)";
+                        }
+                    }
                     throw ArgParseError(ss.str());
                 } else {
                     //Positional argument
@@ -287,68 +468,485 @@ namespace argparse {
                     }
 
                     auto value = arg_strs[i];
-                    specified_arguments.insert(pos_arg);
+                    mark_specified(pos_arg);
                 }
             }
         }
+        return arg_strs.size();
+    }
 
-        //Missing positionals?
-        for(const auto& remaining_positional : positional_args) {
-            std::stringstream ss;
-            ss << "Missing required positional argument: " << remaining_positional->long_option();
-            throw ArgParseError(ss.str());
+    bool ArgumentParser::mark_specified(const std::shared_ptr<Argument>& arg) {
+        size_t idx = argument_indices_[arg.get()];
+        bool first = !specified_.test(idx);
+        specified_.set(idx);
+        return first;
+    }
+
+    void ArgumentParser::check_required(const PmrVector<std::shared_ptr<Argument>>& args) const {
+        for (const auto& arg : args) {
+            if (arg->required()) {
+                if (!specified_.test(argument_indices_.find(arg.get())->second)) {
+                    std::stringstream msg;
+                    msg << "Missing required argument: " << arg->long_option();
+                    auto short_opt = arg->short_option();
+                    if (!short_opt.empty()) {
+                        msg << "/" << short_opt;
+                    }
+                    throw ArgParseError(msg.str());
+                }
+            }
         }
+    }
 
-        //Missing required?
-        for (const auto& group : argument_groups()) {
-            for (const auto& arg : group.arguments()) {
-                if (arg->required()) {
-                    //potentially slow...
-                    if (!specified_arguments.count(arg)) {
-                        std::stringstream msg;
-                        msg << "Missing required argument: " << arg->long_option();
-                        auto short_opt = arg->short_option();
-                        if (!short_opt.empty()) {
-                            msg << "/" << short_opt;
-                        }
-                        throw ArgParseError(msg.str());
+    void ArgumentParser::check_constraints() {
+        if (constraints_.empty()) return;
+
+        if (!constraints_resolved_) {
+            for (auto& constraint : constraints_) {
+                if (!constraint.option.empty()) {
+                    constraint.option_idx = argument_indices_[find_argument(constraint.option).get()];
+                }
+                constraint.mask.resize(arguments_.size());
+                for (const auto& name : constraint.options) {
+                    constraint.mask.set(argument_indices_[find_argument(name).get()]);
+                }
+            }
+            constraints_resolved_ = true;
+        }
+
+        //Returns the names of the specified (or unspecified) arguments in mask
+        auto names = [&](const DynamicBitset& mask, bool specified) {
+            std::vector<std::string> arg_names;
+            for (size_t i = 0; i < mask.size(); ++i) {
+                if (mask.test(i) && specified_.test(i) == specified) {
+                    arg_names.push_back(arguments_[i]->name());
+                }
+            }
+            return arg_names;
+        };
+
+        for (const auto& constraint : constraints_) {
+            switch (constraint.kind) {
+                case ConstraintKind::MUTUALLY_EXCLUSIVE:
+                    if (constraint.mask.count_common(specified_) > 1) {
+                        throw ArgParseError("Arguments " + join(names(constraint.mask, true), ", ") + " are mutually exclusive");
+                    }
+                    break;
+                case ConstraintKind::AT_LEAST_ONE_OF:
+                    if (!constraint.mask.intersects(specified_)) {
+                        throw ArgParseError("Missing required argument: one of " + join(constraint.options, ", "));
+                    }
+                    break;
+                case ConstraintKind::REQUIRES:
+                    if (specified_.test(constraint.option_idx) && !constraint.mask.is_subset_of(specified_)) {
+                        throw ArgParseError("Argument " + arguments_[constraint.option_idx]->name()
+                                            + " requires " + join(names(constraint.mask, false), ", "));
+                    }
+                    break;
+                case ConstraintKind::CONFLICTS:
+                    if (specified_.test(constraint.option_idx) && constraint.mask.intersects(specified_)) {
+                        throw ArgParseError("Argument " + arguments_[constraint.option_idx]->name()
+                                            + " can not be used with " + join(names(constraint.mask, true), ", "));
                     }
+                    break;
+                default:
+                    assert(false);
+            }
+        }
+    }
+
+    std::shared_ptr<Argument> ArgumentParser::find_argument(const std::string& name) const {
+        auto arg = option_index_.find(StrRef(name));
+        if (arg) return arg;
+
+        for (const auto& positional : arguments_) {
+            if (positional->positional() && positional->long_option() == name) {
+                return positional;
+            }
+        }
+        throw ArgParseError("Unknown argument '" + name + "'");
+    }
+
+    void ArgumentParser::update_changes(const PmrVector<std::shared_ptr<Argument>>& args) {
+        if (!track_changes_) return;
+
+        if (changed_.size() != arguments_.size()) {
+            changed_.resize(arguments_.size());
+        } else {
+            changed_.clear();
+        }
+
+        //Destinations are snapshotted after each successful parse, so any difference
+        //is relative to the previous one
+        for (const auto& arg : args) {
+            if (arg->dest_changed()) {
+                changed_.set(argument_indices_[arg.get()]);
+                arg->snapshot_dest();
+            }
+        }
+        if (!changed_.any()) return;
+
+        if (!change_watchers_resolved_) {
+            for (auto& watcher : change_watchers_) {
+                if (watcher.watched_options.empty()) {
+                    watcher.watched = DynamicBitset();
+                    continue;
+                }
+                watcher.watched.resize(arguments_.size());
+                for (const auto& name : watcher.watched_options) {
+                    watcher.watched.set(argument_indices_[find_argument(name).get()]);
+                }
+            }
+            change_watchers_resolved_ = true;
+        }
+
+        for (const auto& watcher : change_watchers_) {
+            if (watcher.watched_options.empty() || changed_.intersects(watcher.watched)) {
+                watcher.callback(*this);
+            }
+        }
+    }
+
+    ArgumentParser& ArgumentParser::track_changes(bool enable) {
+        track_changes_ = enable;
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::on_change(ChangeCallback callback, std::vector<std::string> watched_options) {
+        change_watchers_.push_back({callback, watched_options, DynamicBitset()});
+        change_watchers_resolved_ = false;
+        return track_changes(true);
+    }
+
+    ArgumentParser& ArgumentParser::mutually_exclusive(std::vector<std::string> options) {
+        if (options.size() < 2) {
+            throw ArgParseError("Mutually exclusive arguments require at least two options");
+        }
+        constraints_.push_back({ConstraintKind::MUTUALLY_EXCLUSIVE, std::string(), options, 0, DynamicBitset()});
+        constraints_resolved_ = false;
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::at_least_one_of(std::vector<std::string> options) {
+        if (options.empty()) {
+            throw ArgParseError("At least one option must be specified");
+        }
+        constraints_.push_back({ConstraintKind::AT_LEAST_ONE_OF, std::string(), options, 0, DynamicBitset()});
+        constraints_resolved_ = false;
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::if_specified_requires(std::string option, std::vector<std::string> required_options) {
+        if (option.empty() || required_options.empty()) {
+            throw ArgParseError("Required arguments must specify an option and the options it requires");
+        }
+        constraints_.push_back({ConstraintKind::REQUIRES, option, required_options, 0, DynamicBitset()});
+        constraints_resolved_ = false;
+        return *this;
+    }
+
+    ArgumentParser& ArgumentParser::if_specified_conflicts(std::string option, std::vector<std::string> conflicting_options) {
+        if (option.empty() || conflicting_options.empty()) {
+            throw ArgParseError("Conflicting arguments must specify an option and the options it conflicts with");
+        }
+        constraints_.push_back({ConstraintKind::CONFLICTS, option, conflicting_options, 0, DynamicBitset()});
+        constraints_resolved_ = false;
+        return *this;
+    }
+
+    bool ArgumentParser::changed(const std::string& name) {
+        update_option_index();
+        auto idx = argument_indices_[find_argument(name).get()];
+        return idx < changed_.size() && changed_.test(idx);
+    }
+
+    std::vector<std::shared_ptr<Argument>> ArgumentParser::changed_arguments() const {
+        std::vector<std::shared_ptr<Argument>> args;
+        for (size_t i = 0; i < changed_.size(); ++i) {
+            if (changed_.test(i)) {
+                args.push_back(arguments_[i]);
+            }
+        }
+        return args;
+    }
+
+    std::vector<std::string> ArgumentParser::canonical_command_line() {
+        std::vector<std::string> tokens;
+        visit_canonical_command_line([&](const std::string& token) {
+            tokens.push_back(token);
+        });
+        return tokens;
+    }
+
+    uint64_t ArgumentParser::canonical_hash() {
+        Fnv1aHasher hasher;
+        visit_canonical_command_line([&](const std::string& token) {
+            hasher.update(token);
+        });
+        return hasher.hash();
+    }
+
+    void ArgumentParser::visit_canonical_command_line(const std::function<void(const std::string&)>& visitor) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        PmrVector<std::shared_ptr<Argument>> options(memory_resource_);
+        for (const auto& arg : arguments_) {
+            if (arg->dest_provenance() == Provenance::UNSPECIFIED
+                || arg->dest_provenance() == Provenance::DEFAULT
+                || arg->action() == Action::HELP
+                || arg->action() == Action::VERSION
+                || !arg->dest_set_by_this()
+                || arg->dest_equals_default()) {
+                continue;
+            }
+
+            if (arg->positional()) {
+                //Positional arguments are identified by their order
+                for (const auto& str : arg->dest_value_strs()) {
+                    visitor(str);
+                }
+            } else {
+                options.push_back(arg);
+            }
+        }
+
+        std::sort(options.begin(), options.end(), [](const std::shared_ptr<Argument>& lhs, const std::shared_ptr<Argument>& rhs) {
+            return lhs->long_option() < rhs->long_option();
+        });
+
+        for (const auto& arg : options) {
+            if (arg->action() == Action::STORE_TRUE || arg->action() == Action::STORE_FALSE) {
+                //A flag which differs from its default can only have been set by specifying it
+                visitor(arg->long_option());
+            } else {
+                visitor(arg->long_option());
+                for (const auto& str : arg->dest_value_strs()) {
+                    visitor(str);
                 }
             }
         }
+
+        if (active_subparser_) {
+            visitor(subparsers_->dest_.value());
+            active_subparser_->visit_canonical_command_line(visitor);
+        }
+    }
+
+    void ArgumentParser::parse_subcommand(const std::string& name, std::vector<std::string> arg_strs) {
+        subparsers_->dest_.set(name, Provenance::SPECIFIED);
+        active_subparser_ = &subcommand_parser(name);
+        active_subparser_->parse_args_throw(arg_strs);
+    }
+
+    ArgumentParser& ArgumentParser::subcommand_parser(const std::string& name) {
+        auto subcommand = subparsers_->find(name);
+        assert(subcommand);
+
+        if (!subcommand->parser) {
+            //Only construct the parser (and its arguments) of selected subcommands
+            subcommand->parser.reset(new ArgumentParser(prog_ + " " + name, subcommand->help, memory_resource_, os_));
+            subcommand->factory(*subcommand->parser);
+        }
+        return *subcommand->parser;
+    }
+
+    ArgumentParser& ArgumentParser::innermost_active_parser() {
+        if (active_subparser_) {
+            return active_subparser_->innermost_active_parser();
+        }
+        return *this;
     }
 
     void ArgumentParser::reset_destinations() {
-        for (const auto& group : argument_groups()) {
+        for (const auto& group : argument_groups_) {
             for (const auto& arg : group.arguments()) {
                 arg->reset_dest();
             }
         }
+
+        reset_subcommands();
+        specified_.clear();
+        parsed_ = false;
+        changed_.clear();
+        string_arena_.reset();
+        live_arena_size_ = 0;
+    }
+
+    void ArgumentParser::reset_subcommands() {
+        if (subparsers_) {
+            subparsers_->dest_ = ArgValue<std::string>();
+            for (const auto& subcommand : subparsers_->subcommands_) {
+                if (subcommand.parser) {
+                    subcommand.parser->reset_destinations();
+                }
+            }
+        }
+        active_subparser_ = nullptr;
     }
 
     void ArgumentParser::print_usage() {
-        formatter_->set_parser(this);
-        os_ << formatter_->format_usage();
+        OstreamSink sink(os_);
+        print_usage(sink);
     }
 
     void ArgumentParser::print_help() {
-        formatter_->set_parser(this);
-        os_ << formatter_->format_usage();
-        os_ << formatter_->format_description();
-        os_ << formatter_->format_arguments();
-        os_ << formatter_->format_epilog();
+        OstreamSink sink(os_);
+        print_help(sink);
     }
 
     void ArgumentParser::print_version() {
+        OstreamSink sink(os_);
+        print_version(sink);
+    }
+
+    void ArgumentParser::print_usage(FormatSink& sink) {
+        auto prerendered = current_prerendered_help();
+        if (prerendered) {
+            sink.write(prerendered->usage);
+        } else {
+            formatter().write_usage(sink);
+        }
+        sink.flush();
+    }
+
+    void ArgumentParser::print_help(FormatSink& sink) {
+        auto prerendered = current_prerendered_help();
+        if (prerendered) {
+            sink.write(prerendered->help);
+        } else {
+            auto& fmt = formatter();
+            fmt.write_usage(sink);
+            fmt.write_description(sink);
+            fmt.write_arguments(sink);
+            fmt.write_epilog(sink);
+        }
+        sink.flush();
+    }
+
+    void ArgumentParser::print_version(FormatSink& sink) {
+        formatter().write_version(sink);
+        sink.flush();
+    }
+
+    const std::string& ArgumentParser::prog() const { return prog_; }
+    const std::string& ArgumentParser::version() const { return version_; }
+    const std::string& ArgumentParser::description() const { return description_; }
+    const std::string& ArgumentParser::epilog() const { return epilog_; }
+    bool ArgumentParser::allow_abbrev() const { return allow_abbrev_; }
+    std::vector<ArgumentGroup> ArgumentParser::argument_groups() const {
+        return std::vector<ArgumentGroup>(argument_groups_.begin(), argument_groups_.end());
+    }
+
+    const PmrVector<ArgumentGroup>& ArgumentParser::argument_groups_view() const { return argument_groups_; }
+    const Subparsers* ArgumentParser::subparsers() const { return subparsers_.get(); }
+    ArgumentParser* ArgumentParser::active_subparser() const { return active_subparser_; }
+    MemoryResource* ArgumentParser::memory_resource() const { return memory_resource_; }
+
+    Formatter& ArgumentParser::formatter() {
+        //Only constructed when help is first needed, which most runs never do
+        if (!formatter_) {
+            formatter_.reset(new DefaultFormatter());
+        }
         formatter_->set_parser(this);
-        os_ << formatter_->format_version();
+        return *formatter_;
+    }
+
+    const PrerenderedHelp* ArgumentParser::current_prerendered_help() {
+        if (prerendered_help_ && prerendered_help_->schema_json_hash == schema_json_hash()) {
+            return prerendered_help_;
+        }
+        return nullptr;
+    }
+
+    size_t ArgumentParser::parse_fixed_arity_values(Argument& arg, const OptionMatch& match, const std::vector<std::string>& arg_strs, size_t iopt, bool first_occurrence) {
+        if (!first_occurrence) {
+            throw ArgParseError("Argument " + arg.name() + " specified multiple times");
+        }
+
+        //Values are referenced in place (rather than copied), and any further values are
+        //left for the following options or positional arguments
+        size_t num_values = arg.num_values();
+        size_t num_attached = match.has_attached_value ? 1 : 0;
+        size_t next_idx = iopt + 1;
+        while (next_idx - iopt - 1 + num_attached < num_values
+               && next_idx < arg_strs.size()
+               && !option_index_.is_option(arg_strs[next_idx], allow_abbrev_)) {
+            ++next_idx;
+        }
+        ValueStrs values(match.has_attached_value ? &match.attached_value : nullptr,
+                         arg_strs.data() + iopt + 1, next_idx - iopt - 1);
+
+        if (values.size() < num_values) {
+            std::stringstream msg;
+            msg << "Expected " << num_values << " values for argument '" << arg_strs[iopt] << "'";
+            msg << " (found " << values.size() << ")";
+            throw ArgParseError(msg.str());
+        }
+
+        for (size_t ivalue = 0; ivalue < values.size(); ++ivalue) {
+            if (!is_valid_choice(values[ivalue], arg.choices())) {
+                std::stringstream msg;
+                msg << "Unexpected option value '" << values[ivalue] << "' (expected one of: " << join(arg.choices(), ", ");
+                msg << ") for " << arg.name();
+                throw ArgParseError(msg.str());
+            }
+        }
+
+        try {
+            arg.set_dest_to_values(values);
+        } catch (const ArgParseConversionError& e) {
+            std::stringstream msg;
+            msg << e.what() << " for " << arg.long_option();
+            auto short_opt = arg.short_option();
+            if (!short_opt.empty()) {
+                msg << "/" << short_opt;
+            }
+            throw ArgParseConversionError(msg.str());
+        }
+
+        return next_idx - 1;
+    }
+
+    void ArgumentParser::apply_flag_action(Argument& arg) {
+        if (arg.action() == Action::STORE_TRUE) {
+            arg.set_dest_to_true(); 
+        } else if (arg.action() == Action::STORE_FALSE) {
+            arg.set_dest_to_false();
+        } else if (arg.action() == Action::HELP) {
+            arg.set_dest_to_true(); 
+            throw ArgParseHelp();
+        } else {
+            assert(arg.action() == Action::VERSION);
+            arg.set_dest_to_true(); 
+            throw ArgParseVersion();
+        }
     }
 
-    std::string ArgumentParser::prog() const { return prog_; }
-    std::string ArgumentParser::version() const { return version_; }
-    std::string ArgumentParser::description() const { return description_; }
-    std::string ArgumentParser::epilog() const { return epilog_; }
-    std::vector<ArgumentGroup> ArgumentParser::argument_groups() const { return argument_groups_; }
+    void ArgumentParser::update_option_index() {
+        //Arguments can only be added (not removed or renamed), so a change in
+        //the number of arguments indicates the index is stale
+        size_t num_arguments = 0;
+        for (const auto& group : argument_groups_) {
+            num_arguments += group.arguments().size();
+        }
+        if (num_arguments == arguments_.size()) return;
+
+        PmrVector<std::shared_ptr<Argument>> arguments(memory_resource_);
+        for (const auto& group : argument_groups_) {
+            arguments.insert(arguments.end(), group.arguments().begin(), group.arguments().end());
+        }
+
+        option_index_.build(arguments);
+        arguments_ = std::move(arguments);
+
+        argument_indices_.clear();
+        for (size_t i = 0; i < arguments_.size(); ++i) {
+            argument_indices_[arguments_[i].get()] = i;
+        }
+        change_watchers_resolved_ = false;
+        constraints_resolved_ = false;
+    }
 
     void ArgumentParser::add_help_option_if_unspecified() {
         //Has a help already been specified
@@ -372,53 +970,144 @@ namespace argparse {
         }
     }
 
-    ArgumentParser::ShortArgInfo ArgumentParser::no_space_short_arg(std::string str, const std::map<std::string, std::shared_ptr<Argument>>& str_to_option_arg) const {
+    ArgumentParser::OptionMatch ArgumentParser::match_option(const std::string& str) const {
+        OptionMatch match;
+
+        //Exact match to short/long option
+        match.arg = option_index_.find(StrRef(str));
+        if (match.arg) return match;
 
-        ShortArgInfo short_arg_info;
-        for(auto kv : str_to_option_arg) {
-            if (kv.first.size() == 2) {
-                //Is a short arg
-                
-                //String starts with short arg
-                bool match = true;
-                for (size_t i = 0; i < kv.first.size(); ++i) {
-                    if (kv.first[i] != str[i]) {
-                        match = false;
-                        break;
+        //Long option with an attached value (e.g. '--foo=bar')
+        match.arg = option_index_.find_with_attached_value(str, match.attached_value);
+        if (match.arg) {
+            match.has_attached_value = true;
+            return match;
+        }
+
+        //Short option with no space between the option and value (e.g. '-j3'),
+        //or packed short options (e.g. '-xvf', or '-xvj3' where '-j' accepts a value)
+        if (str.size() > 2 && str[0] == '-' && str[1] != '-') {
+            for (size_t i = 1; i < str.size(); ++i) {
+                auto arg = option_index_.find_short(str[i]);
+                if (!arg) {
+                    if (i == 1) break; //Not a short option
+
+                    std::stringstream msg;
+                    msg << "Unrecognized option '-" << str[i] << "' in '" << str << "'";
+                    throw ArgParseError(msg.str());
+                }
+
+                if (arg->action() == Action::STORE) {
+                    //Any remaining characters are the value
+                    match.arg = arg;
+                    if (i + 1 < str.size()) {
+                        match.has_attached_value = true;
+                        match.attached_value.assign(str, i + 1, std::string::npos);
                     }
+                    break;
+                } else if (i + 1 == str.size()) {
+                    //Last flag in the packed string
+                    match.arg = arg;
+                } else {
+                    match.packed_flags.push_back(arg);
                 }
+            }
+        }
 
-                bool no_space_between_short_arg_and_value = str.size() > kv.first.size();
+        //Abbreviated long option, potentially with an attached value (e.g. '--fo' or '--fo=bar')
+        if (allow_abbrev_ && str.size() > 2 && str[0] == '-' && str[1] == '-') {
+            size_t eq_pos = str.find('=', 2);
+            match.arg = option_index_.find_abbreviation(StrRef(str.data(), std::min(eq_pos, str.size())));
+            if (match.arg && eq_pos != std::string::npos) {
+                match.has_attached_value = true;
+                match.attached_value.assign(str, eq_pos + 1, std::string::npos);
+            }
+        }
+        return match;
+    }
 
-                if (match && no_space_between_short_arg_and_value) {
-                    //Only handles cases where there is no space between short arg and value
-                    short_arg_info.is_no_space_short_arg = true;
-                    short_arg_info.arg = kv.second;
-                    short_arg_info.value = std::string(str.begin() + kv.first.size(), str.end());
+    /*
+     * Subparsers
+     */
+    Subparsers::Subparsers(ArgValue<std::string>& dest, std::string title_str)
+        : dest_(dest)
+        , title_(title_str)
+        {}
 
-                    return short_arg_info;
-                }
+    Subparsers& Subparsers::add_parser(std::string name, SubparserFactory factory, std::string help_str) {
+        if (find(name)) {
+            throw ArgParseError("Subcommand '" + name + "' specified multiple times");
+        }
+        if (name.empty() || name[0] == '-') {
+            throw ArgParseError("Subcommand name '" + name + "' must be non-empty and not start with '-'");
+        }
+
+        Subcommand subcommand;
+        subcommand.name = name;
+        subcommand.help = help_str;
+        subcommand.factory = factory;
+        subcommands_.push_back(std::move(subcommand));
+        return *this;
+    }
+
+    Subparsers& Subparsers::required(bool is_required) {
+        required_ = is_required;
+        return *this;
+    }
+
+    std::string Subparsers::title() const { return title_; }
+    bool Subparsers::required() const { return required_; }
+
+    std::vector<std::string> Subparsers::names() const {
+        std::vector<std::string> names_vec;
+        for (const auto& subcommand : subcommands_) {
+            names_vec.push_back(subcommand.name);
+        }
+        return names_vec;
+    }
+
+    std::string Subparsers::help(const std::string& name) const {
+        auto subcommand = find(name);
+        if (!subcommand) {
+            throw ArgParseError("Unknown subcommand '" + name + "'");
+        }
+        return subcommand->help;
+    }
+
+    ArgumentParser* Subparsers::parser(const std::string& name) const {
+        auto subcommand = find(name);
+        if (!subcommand) return nullptr;
+        return subcommand->parser.get();
+    }
+
+    Subparsers::Subcommand* Subparsers::find(const std::string& name) {
+        for (auto& subcommand : subcommands_) {
+            if (subcommand.name == name) {
+                return &subcommand;
             }
         }
+        return nullptr;
+    }
 
-        assert(!short_arg_info.is_no_space_short_arg);
-        return short_arg_info;
+    const Subparsers::Subcommand* Subparsers::find(const std::string& name) const {
+        return const_cast<Subparsers*>(this)->find(name);
     }
 
     /*
      * ArgumentGroup
      */
-    ArgumentGroup::ArgumentGroup(std::string name_str)
+    ArgumentGroup::ArgumentGroup(std::string name_str, MemoryResource* resource)
         : name_(name_str)
+        , arguments_(resource)
         {}
 
     ArgumentGroup& ArgumentGroup::epilog(std::string str) {
         epilog_ = str;
         return *this;
     }
-    std::string ArgumentGroup::name() const { return name_; }
-    std::string ArgumentGroup::epilog() const { return epilog_; }
-    const std::vector<std::shared_ptr<Argument>>& ArgumentGroup::arguments() const { return arguments_; }
+    const std::string& ArgumentGroup::name() const { return name_; }
+    const std::string& ArgumentGroup::epilog() const { return epilog_; }
+    const PmrVector<std::shared_ptr<Argument>>& ArgumentGroup::arguments() const { return arguments_; }
 
     /*
      * Argument
@@ -441,6 +1130,8 @@ namespace argparse {
 
         //Set defaults
         metavar_ = toupper(dashes_name[1]);
+
+        name_id_ = intern_string(name());
     }
 
     Argument& Argument::help(std::string help_str) {
@@ -468,7 +1159,41 @@ namespace argparse {
             throw ArgParseError("STORE action requires nargs to be '1', '+' or '*'");
         }
 
+        //Destinations holding a fixed number of values require exactly that many
+        size_t arity = dest_arity();
+        if (arity > 0 && (nargs_type != '1' || arity != 1)) {
+            std::stringstream msg;
+            msg << "Argument " << name() << " requires nargs to be " << arity << " (to match its destination)";
+            throw ArgParseError(msg.str());
+        }
+
         nargs_ = nargs_type;
+        num_values_ = (nargs_type == '0') ? 0 : 1;
+
+        valid_action();
+        return *this;
+    }
+
+    Argument& Argument::nargs(int num_values_expected) {
+        if (num_values_expected < 0) {
+            throw ArgParseError("Invalid argument to nargs (number of values must be non-negative)");
+        } else if (num_values_expected <= 1) {
+            return nargs(num_values_expected == 0 ? '0' : '1');
+        }
+
+        if (action() != Action::STORE) {
+            throw ArgParseError("Multiple values require the STORE action");
+        }
+
+        size_t arity = dest_arity();
+        if (arity > 0 && arity != size_t(num_values_expected)) {
+            std::stringstream msg;
+            msg << "Argument " << name() << " requires nargs to be " << arity << " (to match its destination)";
+            throw ArgParseError(msg.str());
+        }
+
+        nargs_ = 'N';
+        num_values_ = num_values_expected;
 
         valid_action();
         return *this;
@@ -493,7 +1218,7 @@ namespace argparse {
             || action_ == Action::VERSION) {
             this->nargs('0');
         } else if (action_ == Action::STORE) {
-            this->nargs('1');
+            this->nargs(std::max<int>(dest_arity(), 1));
         } else {
             throw ArgParseError("Unrecognized argparse action");
         }
@@ -515,17 +1240,33 @@ namespace argparse {
         default_value_.clear();
         default_value_.push_back(value);
         default_set_ = true;
+        {
+            //Defaults are converted once, and must outlive any parse's string arena
+            StringArenaScope no_arena(nullptr);
+            convert_default_value();
+        }
         return *this;
     }
 
     Argument& Argument::default_value(const std::vector<std::string>& values) {
-        if (nargs() != '+' && nargs() != '*') {
+        if (nargs() == 'N') {
+            if (values.size() != num_values()) {
+                std::stringstream msg;
+                msg << "Expected " << num_values() << " default values for " << name() << " (found " << values.size() << ")";
+                throw ArgParseError(msg.str());
+            }
+        } else if (nargs() != '+' && nargs() != '*') {
             std::stringstream msg;
             msg << "Multiple default value not allowed for nargs='" << nargs() << "'";
             throw ArgParseError(msg.str());
         }
         default_value_ = values;
         default_set_ = true;
+        {
+            //Defaults are converted once, and must outlive any parse's string arena
+            StringArenaScope no_arena(nullptr);
+            convert_default_value();
+        }
         return *this;
     }
 
@@ -536,6 +1277,7 @@ namespace argparse {
 
     Argument& Argument::group_name(std::string grp) {
         group_name_ = grp;
+        group_id_ = intern_string(grp);
         return *this;
     }
 
@@ -552,12 +1294,13 @@ namespace argparse {
         return name_str;
     }
 
-    std::string Argument::long_option() const { return long_opt_; }
-    std::string Argument::short_option() const { return short_opt_; }
-    std::string Argument::help() const { return help_; }
+    const std::string& Argument::long_option() const { return long_opt_; }
+    const std::string& Argument::short_option() const { return short_opt_; }
+    const std::string& Argument::help() const { return help_; }
     char Argument::nargs() const { return nargs_; }
-    std::string Argument::metavar() const { return metavar_; }
-    std::vector<std::string> Argument::choices() const { return choices_; }
+    size_t Argument::num_values() const { return num_values_; }
+    const std::string& Argument::metavar() const { return metavar_; }
+    const std::vector<std::string>& Argument::choices() const { return choices_; }
     Action Argument::action() const { return action_; }
     std::string Argument::default_value() const { 
         if (default_value_.size() > 1) {
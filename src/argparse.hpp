@@ -1,22 +1,44 @@
 #ifndef ARGPARSE_H
 #define ARGPARSE_H
+#include <algorithm>
+#include <array>
 #include <iosfwd>
 #include <string>
 #include <vector>
-#include <iostream>
 #include <sstream>
 #include <memory>
 #include <map>
+#include <set>
+#include <functional>
+#include <unordered_map>
+#include <list>
+#include <tuple>
+#include <utility>
 
 #include "argparse_formatter.hpp"
+#include "argparse_memory.hpp"
 #include "argparse_default_converter.hpp"
 #include "argparse_error.hpp"
 #include "argparse_value.hpp"
+#include "argparse_option_index.hpp"
+#include "argparse_snapshot.hpp"
 
 namespace argparse {
 
     class Argument;
     class ArgumentGroup;
+    class ArgumentParser;
+    class Subparsers;
+
+    //Adds the arguments of a subcommand to its (newly constructed) parser
+    typedef std::function<void(ArgumentParser&)> SubparserFactory;
+
+    //Notified of the arguments changed by a parse (see ArgumentParser::on_change())
+    typedef std::function<void(const ArgumentParser&)> ChangeCallback;
+
+    //Notified of each record parsed from a stream (see ArgumentParser::parse_stream()), with the
+    //record's index and the error it failed to parse with (or nullptr if it parsed successfully)
+    typedef std::function<void(size_t record_index, const ArgParseError* error)> RecordCallback;
 
     enum class Action {
         STORE,
@@ -31,10 +53,49 @@ namespace argparse {
         HELP_ONLY
     };
 
+    enum class ValueDumpFormat {
+        JSON_LINES, //One JSON object per line
+        CSV         //Comma separated values, with a header line
+    };
+
+    //Help rendered at build time (see prerender_help_main()), which a parser serves in place of
+    //formatting its help at run-time while its schema is unchanged (see ArgumentParser::prerendered_help())
+    struct PrerenderedHelp {
+        uint64_t schema_json_hash; //ArgumentParser::schema_json_hash() of the parser it was rendered from
+        const char* usage;
+        const char* help;
+        const char* man_page;
+        const char* markdown;
+    };
+
+    //Statistics of a streamed parse (see ArgumentParser::parse_stream())
+    struct StreamStats {
+        size_t num_records = 0;
+        size_t num_failed = 0; //Records which failed to parse
+        size_t num_bytes = 0;
+        double seconds = 0.; //Wall-clock time, including waiting for input
+
+        double records_per_second() const;
+    };
+
+    enum class CompletionShell {
+        BASH,
+        ZSH,
+        FISH
+    };
+
     class ArgumentParser {
         public:
-            //Initializes an argument parser
-            ArgumentParser(std::string prog_name, std::string description_str=std::string(), std::ostream& os=std::cout);
+            //Initializes an argument parser, which prints (e.g. its help) to os, or standard output if unspecified
+            // (Overloaded rather than defaulting os to std::cout, so this header need not include <iostream>)
+            ArgumentParser(std::string prog_name, std::string description_str=std::string());
+            ArgumentParser(std::string prog_name, std::string description_str, std::ostream& os);
+
+            //Initializes an argument parser whose internal storage (including the arguments
+            //it defines) is allocated from resource, which must outlive the parser and any
+            //Argument pointers obtained from it. Subcommand parsers share the same resource.
+            ArgumentParser(std::string prog_name, std::string description_str, MemoryResource* resource);
+            ArgumentParser(std::string prog_name, std::string description_str, MemoryResource* resource, std::ostream& os);
 
             //Overrides the program name
             ArgumentParser& prog(std::string prog, bool basename_only=true);
@@ -45,6 +106,14 @@ namespace argparse {
             //Specifies the epilog text at the bottom of the help description
             ArgumentParser& epilog(std::string prog);
 
+            //Sets whether long options may be abbreviated to any unique prefix (e.g. '--verb' for '--verbosity')
+            ArgumentParser& allow_abbrev(bool allow);
+
+            //Sets help rendered at build time (which must outlive the parser), to be printed instead of
+            //formatting the help at run-time. If the parser's definition no longer matches the one the help
+            //was rendered from (e.g. it changed since the help was generated), the help is formatted as usual.
+            ArgumentParser& prerendered_help(const PrerenderedHelp* help);
+
             //Adds an argument or option with a single name (single value)
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<T>& dest, std::string option);
@@ -61,9 +130,28 @@ namespace argparse {
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt);
 
+            //Adds an option taking exactly N values (e.g. '--bbox x0 y0 x1 y1'), each converted by Converter
+            template<typename T, size_t N, typename Converter=DefaultConverter<T>>
+            Argument& add_argument(ArgValue<std::array<T,N>>& dest, std::string option);
+
+            template<typename T, size_t N, typename Converter=DefaultConverter<T>>
+            Argument& add_argument(ArgValue<std::array<T,N>>& dest, std::string long_opt, std::string short_opt);
+
+            //Adds an option taking exactly one value for each element of the tuple (each with its default conversion)
+            template<typename... Ts>
+            Argument& add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string option);
+
+            template<typename... Ts>
+            Argument& add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string long_opt, std::string short_opt);
+
             //Adds a group to collect related arguments
             ArgumentGroup& add_argument_group(std::string description_str);
 
+            //Adds subcommands (e.g. 'prog pack ...', 'prog route ...'), each with its own parser.
+            //The first non-option after any positional arguments selects the subcommand, whose name
+            //is stored in dest, and all following arguments are parsed by the subcommand's parser.
+            Subparsers& add_subparsers(ArgValue<std::string>& dest, std::string title="subcommands");
+
             //Like parse_arg_throw(), but catches exceptions and exits the program
             void parse_args(int argc, const char* const* argv, int error_exit_code=1, int help_exit_code=0, int version_exit_code=0);
 
@@ -72,11 +160,126 @@ namespace argparse {
             //If an error occurs throws ArgParseError
             //If an help is requested occurs throws ArgParseHelp
             void parse_args_throw(int argc, const char* const* argv);
-            void parse_args_throw(std::vector<std::string> args);
+            void parse_args_throw(const std::vector<std::string>& args);
+
+#ifndef _WIN32
+            //Parses each command-line read from fd (until end of file), calling callback after each.
+            //Arguments are NUL terminated (as by 'find -print0' or for 'xargs -0'), and a record_separator
+            //in place of an argument ends the command-line (e.g. "--foo\0bar\0\n" is {"--foo", "bar"}).
+            //Any command-line left unterminated at end of file is also parsed.
+            //
+            //Input is read chunk_size bytes at a time, and each command-line is parsed as soon as it is
+            //complete, so memory use is bounded by the chunk size (and the longest command-line) rather
+            //than the stream's length. The destinations hold each command-line's values during the callback.
+            //Command-lines failing to parse (or requesting help or the version) are reported to the callback,
+            //but do not stop the stream. Throws ArgParseError if reading fd fails.
+            StreamStats parse_stream(int fd, RecordCallback callback, size_t chunk_size=64*1024, char record_separator='\n');
+#endif
 
-            //Reset the target values to their initial state
+            //Applies a change to the command-line of the previous parse without re-parsing all of it.
+            //The options in changed_args (e.g. {"--alpha_t", "0.9"}) are specified as by parse_args_throw(),
+            //replacing any values they were previously specified with, and the options in removed_options
+            //(e.g. {"--alpha_t"}) revert to their defaults as if they had not been specified.
+            //Only the affected arguments are updated and re-validated. Returns the arguments whose
+            //destination value or provenance changed.
+            //C-string values replaced by changes are reclaimed once they outweigh those still in use
+            //(by re-storing the latter), so repeated changes use bounded memory. Unaffected C-string
+            //values therefore remain valid only until the next change.
+            //If an error occurs throws ArgParseError, after which a full parse is required
+            std::vector<std::shared_ptr<Argument>> parse_args_delta(std::vector<std::string> changed_args,
+                                                                    std::vector<std::string> removed_options=std::vector<std::string>());
+
+            //Reset the target values to their initial state (invalidating any C-string values
+            //converted by the last parse)
             void reset_destinations();
 
+            //Sets whether to track which argument destinations are changed (in value or provenance)
+            //by each successful parse, compared to the previous successful parse. Disabled by default,
+            //since it requires keeping a copy of each destination value.
+            ArgumentParser& track_changes(bool enable);
+
+            //Registers callback to be called (once) after each successful parse which changed the
+            //destination of any of watched_options (or of any argument if watched_options is empty).
+            //Positional arguments are identified by their name. Enables track_changes().
+            ArgumentParser& on_change(ChangeCallback callback, std::vector<std::string> watched_options=std::vector<std::string>());
+
+            //Constraints between arguments, checked after each parse (and parse_args_delta()). Options are
+            //identified by their option string and positional arguments by their name, and need only have
+            //been added by the time of the first parse. Violations are reported as ArgParseError.
+
+            //Requires that at most one of options is specified
+            ArgumentParser& mutually_exclusive(std::vector<std::string> options);
+
+            //Requires that at least one of options is specified
+            ArgumentParser& at_least_one_of(std::vector<std::string> options);
+
+            //Requires that all of required_options are specified whenever option is
+            ArgumentParser& if_specified_requires(std::string option, std::vector<std::string> required_options);
+
+            //Requires that none of conflicting_options are specified whenever option is
+            ArgumentParser& if_specified_conflicts(std::string option, std::vector<std::string> conflicting_options);
+
+            //Returns true if the last successful parse changed the destination of the named option
+            //or positional argument (requires track_changes())
+            bool changed(const std::string& name);
+
+            //Returns the arguments whose destinations were changed by the last successful parse
+            //(requires track_changes())
+            std::vector<std::shared_ptr<Argument>> changed_arguments() const;
+
+            //Writes a binary snapshot of the values and provenance of all argument destinations.
+            //Values are stored in their binary form (in native byte order), so the snapshot can
+            //only be loaded by a parser with identical arguments on the same platform.
+            //Subcommand parsers are not included.
+            void save_snapshot(std::ostream& os);
+
+            //Restores the argument destinations from a snapshot written by save_snapshot(), as if
+            //the command-line which produced them had been parsed. The file is memory-mapped (where
+            //supported) and values are copied directly into the destinations, without conversion.
+            // Throws ArgParseError if the snapshot is invalid, or was saved by a parser with different arguments
+            void load_snapshot(const std::string& filename);
+            void load_snapshot(const char* data, size_t size);
+
+            //Returns a hash of the parser's argument definitions (options, actions, nargs and types)
+            uint64_t schema_hash();
+
+            //Writes the parser's schema as JSON: the program information, the argument groups and
+            //their arguments (options, help, nargs, action, choices, default, visibility and type),
+            //and the names of any subcommands. Intended for external tools (e.g. launchers) which
+            //would otherwise need to scrape the help output.
+            void write_schema_json(std::ostream& os);
+
+            //Writes the same schema as write_schema_json() in a compact binary form
+            void write_schema_binary(std::ostream& os);
+
+            //Returns a hash of write_schema_json()'s output, which covers everything shown in the help
+            uint64_t schema_json_hash();
+
+            //Writes the JSON schema to a file in cache_dir named by the program and a hash of the
+            //schema (if no such file already exists), and returns its path. Tools can then read
+            //the schema from the cache instead of running the program.
+            std::string write_schema_cache(const std::string& cache_dir);
+
+            //Writes a record for each argument with its name, value(s) (converted by its Converter),
+            //provenance and group, e.g. for logging the effective configuration. In CSV multiple
+            //values are separated by spaces within the value field.
+            void dump_values(std::ostream& os, ValueDumpFormat format=ValueDumpFormat::JSON_LINES);
+
+            //Like dump_values(std::ostream&), but appends to buf (whose capacity can be re-used between calls)
+            void dump_values(std::string& buf, ValueDumpFormat format=ValueDumpFormat::JSON_LINES);
+
+            //Returns a canonical command-line which reproduces the current argument values: positional
+            //arguments (in order) followed by options sorted by long option, each with its value(s)
+            //converted by its Converter. Arguments still at (or explicitly set to) their default, and
+            //unspecified arguments, are omitted. The active subcommand (if any) follows, with its own
+            //canonical arguments. Command-lines differing only in option order, option spelling (e.g.
+            //'-j' vs '--num_workers', '--foo=bar' vs '--foo bar') or value formatting (e.g. '05' vs '5')
+            //therefore produce the same canonical command-line.
+            std::vector<std::string> canonical_command_line();
+
+            //Returns a 64-bit hash of canonical_command_line(), computed incrementally without building it
+            uint64_t canonical_hash();
+
             //Prints the basic usage
             void print_usage();
 
@@ -85,42 +288,238 @@ namespace argparse {
 
             //Prints the version information
             void print_version();
+
+            //As above, but written into sink (e.g. a re-used string or a file descriptor)
+            //rather than the parser's output stream. The sink is flushed afterwards.
+            void print_usage(FormatSink& sink);
+            void print_help(FormatSink& sink);
+            void print_version(FormatSink& sink);
+
+            //Writes a manual page (in roff, for man(1)) describing the program and its arguments
+            void write_man_page(FormatSink& sink);
+
+            //Writes a Markdown document describing the program and its arguments
+            void write_markdown(FormatSink& sink);
+
+            //Writes a C++ source file defining the PrerenderedHelp named variable_name (of static
+            //storage duration, with external linkage) holding the parser's help as currently defined
+            void write_prerendered_help(std::ostream& os, const std::string& variable_name);
+
+            //Returns the candidate completions for the word at index cursor of arg_strs (which, like
+            //parse_args_throw(), excludes the program name). A cursor of arg_strs.size() completes a
+            //new (empty) word. An empty result indicates the word is a free-form value (e.g. a filename).
+            std::vector<std::string> complete(std::vector<std::string> arg_strs, size_t cursor);
+
+            //Writes the completion cache (one line per option string, with its nargs, choices and help)
+            //used by the scripts from completion_script()
+            void write_completion_cache(std::ostream& os);
+
+            //Returns a shell script providing TAB completion for this program, so the program itself
+            //need not be run on each completion. Bash and zsh scripts embed pre-built lookup tables
+            //(options by value count, sorted option strings, and the choices of each option, positional
+            //argument and subcommand). Fish scripts load the completion cache at cache_file.
+            std::string completion_script(CompletionShell shell, std::string cache_file);
         public:
             //Returns the program name
-            std::string prog() const;
+            const std::string& prog() const;
 
-            std::string version() const;
+            const std::string& version() const;
 
             //Returns the program description (after usage, but before option descriptions)
-            std::string description() const;
+            const std::string& description() const;
 
             //Returns the epilog (end of help)
-            std::string epilog() const;
+            const std::string& epilog() const;
+
+            //Returns whether long options may be abbreviated
+            bool allow_abbrev() const;
 
-            //Returns all the argument groups in this parser
+            //Returns (a copy of) all the argument groups in this parser
             std::vector<ArgumentGroup> argument_groups() const;
 
+            //Returns all the argument groups in this parser, without copying them
+            const PmrVector<ArgumentGroup>& argument_groups_view() const;
+
+            //Returns the subcommands of this parser (or nullptr if there are none)
+            const Subparsers* subparsers() const;
+
+            //Returns the parser of the subcommand selected by the last parse (or nullptr if none was)
+            ArgumentParser* active_subparser() const;
+
+            //Returns the resource from which the parser's internal storage is allocated
+            MemoryResource* memory_resource() const;
+
         private:
             void add_help_option_if_unspecified();
 
-            struct ShortArgInfo {
-                bool is_no_space_short_arg = false;
+            //Rebuilds the option index if arguments have been added since it was last built
+            void update_option_index();
+
+            //Processes the options (and positional arguments) in arg_strs, returning the index of
+            //the subcommand in arg_strs if one was found (otherwise arg_strs.size())
+            size_t parse_arg_strs(const std::vector<std::string>& arg_strs, PmrList<std::shared_ptr<Argument>>& positional_args, bool allow_subcommand);
+
+            //Records arg as specified by the current parse, returning true if it was not already
+            bool mark_specified(const std::shared_ptr<Argument>& arg);
+
+            //Throws ArgParseError if any of the required arguments in args were not specified
+            void check_required(const PmrVector<std::shared_ptr<Argument>>& args) const;
+
+            //Throws ArgParseError if the specified arguments violate any constraint
+            void check_constraints();
+
+            //Returns the argument with the specified option string or positional name
+            // Throws ArgParseError if there is no such argument
+            std::shared_ptr<Argument> find_argument(const std::string& name) const;
+
+            //Calls visitor with each token of canonical_command_line()
+            void visit_canonical_command_line(const std::function<void(const std::string&)>& visitor);
+
+            //Records which of args changed since the previous successful parse, and
+            //calls any change callbacks watching them (if change tracking is enabled)
+            void update_changes(const PmrVector<std::shared_ptr<Argument>>& args);
+
+            //Clears the selected subcommand, and the destinations of all constructed subcommand parsers
+            void reset_subcommands();
+
+            //Re-stores the C-string values of the destinations in a reset string_arena_, reclaiming
+            //the storage of values replaced by parse_args_delta()
+            void compact_string_arena();
+
+            //Parses arg_strs with the parser of the named subcommand (constructing it if required)
+            void parse_subcommand(const std::string& name, std::vector<std::string> arg_strs);
+
+            //Returns the parser of the named subcommand, constructing it on first use
+            ArgumentParser& subcommand_parser(const std::string& name);
+
+            //Writes the bash completion function func (and those of any subcommands), which completes
+            //the current word given the words of this parser's arguments start at index $1
+            void write_bash_completion(std::ostream& os, const std::string& func);
+
+            //Returns the parser of the most deeply nested subcommand selected by the last parse (or this parser)
+            ArgumentParser& innermost_active_parser();
+
+            //Applies the action of a flag (i.e. an argument accepting no values)
+            void apply_flag_action(Argument& arg);
+
+            struct OptionMatch {
+                std::vector<std::shared_ptr<argparse::Argument>> packed_flags; //Flags packed before arg (e.g. '-x' and '-v' in '-xvf')
                 std::shared_ptr<argparse::Argument> arg;
-                std::string value;
+                bool has_attached_value = false; //True if the value was part of the same string (e.g. '-j3' or '--foo=bar')
+                std::string attached_value;
             };
-            ShortArgInfo no_space_short_arg(std::string str, const std::map<std::string, std::shared_ptr<Argument>>& str_to_option_arg) const;
+            OptionMatch match_option(const std::string& str) const;
+
+            //Stores the exactly arg.num_values() values of a fixed arity (nargs 'N') option matched at
+            //arg_strs[iopt], returning the index of its last value in arg_strs
+            size_t parse_fixed_arity_values(Argument& arg, const OptionMatch& match, const std::vector<std::string>& arg_strs, size_t iopt, bool first_occurrence);
+
+            //Returns the help formatter (constructing it if needed), set to format this parser
+            Formatter& formatter();
+
+            //Returns the pre-rendered help if it matches the parser's current definition (otherwise nullptr)
+            const PrerenderedHelp* current_prerendered_help();
         private:
+            MemoryResource* memory_resource_; //Source of the internal storage below
+
             std::string prog_;
             std::string description_;
             std::string epilog_;
             std::string version_;
-            std::vector<ArgumentGroup> argument_groups_;
+            bool allow_abbrev_ = false;
+            const PrerenderedHelp* prerendered_help_ = nullptr;
+            PmrVector<ArgumentGroup> argument_groups_;
+
+            OptionIndex option_index_;
+            PmrVector<std::shared_ptr<Argument>> arguments_; //All arguments (in all groups) covered by option_index_
+            DynamicBitset specified_; //Arguments specified by the last parse (indexed as arguments_)
+            bool parsed_ = false; //Whether the last parse completed successfully
+            StringArena string_arena_; //Storage for C-string values converted by the last parse
+            StringArena scratch_arena_; //Storage for C-string values converted only to be validated
+            size_t live_arena_size_ = 0; //Size of string_arena_ after the last full parse (or compaction)
+
+            struct ChangeWatcher {
+                ChangeCallback callback;
+                std::vector<std::string> watched_options;
+                DynamicBitset watched; //Indicies in arguments_ of watched_options (empty if watching all)
+            };
+            bool track_changes_ = false;
+            PmrUnorderedMap<const Argument*,size_t> argument_indices_; //Index of each argument in arguments_
+            DynamicBitset changed_; //Arguments changed by the last successful parse (indexed as arguments_)
+            std::vector<ChangeWatcher> change_watchers_;
+            bool change_watchers_resolved_ = false; //Whether the watched bitsets match arguments_
+
+            enum class ConstraintKind {
+                MUTUALLY_EXCLUSIVE,
+                AT_LEAST_ONE_OF,
+                REQUIRES, //If option is specified, all of options must be
+                CONFLICTS //If option is specified, none of options may be
+            };
+            struct Constraint {
+                ConstraintKind kind;
+                std::string option; //The conditioning option (REQUIRES and CONFLICTS only)
+                std::vector<std::string> options;
+                size_t option_idx = 0; //Index in arguments_ of option
+                DynamicBitset mask; //Indicies in arguments_ of options
+            };
+            std::vector<Constraint> constraints_;
+            bool constraints_resolved_ = false; //Whether the constraint bitsets match arguments_
+
+            std::unique_ptr<Subparsers> subparsers_;
+            ArgumentParser* active_subparser_ = nullptr;
 
             std::unique_ptr<Formatter> formatter_;
             std::ostream& os_;
             ArgValue<bool> show_help_dummy_; //Dummy variable used as destination for automatically generated help option
     };
 
+    class Subparsers {
+        public:
+            //Adds a subcommand. The subcommand's parser is only constructed (by calling
+            //factory) when the subcommand is selected on the command-line.
+            Subparsers& add_parser(std::string name, SubparserFactory factory, std::string help_str=std::string());
+
+            //Sets whether a subcommand must be specified
+            Subparsers& required(bool is_required);
+
+        public:
+            //Returns the title of the subcommands (used in help)
+            std::string title() const;
+
+            //Returns the names of the subcommands (in the order they were added)
+            std::vector<std::string> names() const;
+
+            //Returns the help description of the named subcommand
+            std::string help(const std::string& name) const;
+
+            //Returns whether a subcommand must be specified
+            bool required() const;
+
+            //Returns the parser of the named subcommand, or nullptr if it does not
+            //exist or has not yet been constructed
+            ArgumentParser* parser(const std::string& name) const;
+
+        private:
+            friend class ArgumentParser;
+            Subparsers(ArgValue<std::string>& dest, std::string title_str);
+
+            struct Subcommand {
+                std::string name;
+                std::string help;
+                SubparserFactory factory;
+                std::unique_ptr<ArgumentParser> parser; //Constructed on first use
+            };
+
+            //Returns the named subcommand (or nullptr if it does not exist)
+            Subcommand* find(const std::string& name);
+            const Subcommand* find(const std::string& name) const;
+        private:
+            ArgValue<std::string>& dest_;
+            std::string title_;
+            bool required_ = false;
+            std::vector<Subcommand> subcommands_;
+    };
+
     class ArgumentGroup {
         public:
 
@@ -140,18 +539,32 @@ namespace argparse {
             template<typename T, typename Converter=DefaultConverter<T>>
             Argument& add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt);
 
+            //Adds an option taking exactly N values, each converted by Converter
+            template<typename T, size_t N, typename Converter=DefaultConverter<T>>
+            Argument& add_argument(ArgValue<std::array<T,N>>& dest, std::string option);
+
+            template<typename T, size_t N, typename Converter=DefaultConverter<T>>
+            Argument& add_argument(ArgValue<std::array<T,N>>& dest, std::string long_opt, std::string short_opt);
+
+            //Adds an option taking exactly one value for each element of the tuple
+            template<typename... Ts>
+            Argument& add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string option);
+
+            template<typename... Ts>
+            Argument& add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string long_opt, std::string short_opt);
+
             //Adds an epilog to the group
             ArgumentGroup& epilog(std::string str);
 
         public:
             //Returns the name of the group
-            std::string name() const;
+            const std::string& name() const;
 
             //Returns the epilog
-            std::string epilog() const;
+            const std::string& epilog() const;
 
             //Returns the arguments within the group
-            const std::vector<std::shared_ptr<Argument>>& arguments() const;
+            const PmrVector<std::shared_ptr<Argument>>& arguments() const;
         public:
             ArgumentGroup(const ArgumentGroup&) = default;
             ArgumentGroup(ArgumentGroup&&) = default;
@@ -159,11 +572,35 @@ namespace argparse {
             ArgumentGroup& operator=(const ArgumentGroup&&) = delete;
         private:
             friend class ArgumentParser;
-            ArgumentGroup(std::string name_str=std::string());
+            ArgumentGroup(std::string name_str, MemoryResource* resource);
         private:
             std::string name_;
             std::string epilog_;
-            std::vector<std::shared_ptr<Argument>> arguments_;
+            PmrVector<std::shared_ptr<Argument>> arguments_; //Arguments (and the vector) are allocated from its allocator's resource
+    };
+
+    //View of the values specified for an option: the value attached to the option string
+    //(e.g. '--bbox=1'), if any, followed by those in the subsequent command-line arguments
+    class ValueStrs {
+        public:
+            ValueStrs(const std::string* attached, const std::string* rest, size_t num_rest)
+                : attached_(attached)
+                , rest_(rest)
+                , size_((attached ? 1 : 0) + num_rest)
+                {}
+
+            size_t size() const { return size_; }
+
+            const std::string& operator[](size_t i) const {
+                if (attached_) {
+                    return (i == 0) ? *attached_ : rest_[i - 1];
+                }
+                return rest_[i];
+            }
+        private:
+            const std::string* attached_;
+            const std::string* rest_;
+            size_t size_;
     };
 
     class Argument {
@@ -190,6 +627,9 @@ namespace argparse {
             //Sets the expected number of arguments
             Argument& nargs(char nargs_type);
 
+            //Sets the exact number of values expected (after which nargs() is '0', '1', or 'N' for more than one)
+            Argument& nargs(int num_values_expected);
+
             //Sets the valid choices for this option's value
             Argument& choices(std::vector<std::string> choice_values);
 
@@ -209,6 +649,9 @@ namespace argparse {
             //Adds the specified value to the taget values
             virtual void add_value_to_dest(std::string value) = 0;
 
+            //Sets the target value from exactly num_values() values (nargs 'N')
+            virtual void set_dest_to_values(const ValueStrs& values) = 0;
+
             //Set the target value to true
             virtual void set_dest_to_true() = 0;
 
@@ -216,6 +659,32 @@ namespace argparse {
             virtual void set_dest_to_false() = 0;
 
             virtual void reset_dest() = 0;
+
+            //Records the current target value, to be compared against by dest_changed()
+            virtual void snapshot_dest() = 0;
+
+            //Returns true if the target value or provenance differs from that recorded by snapshot_dest()
+            virtual bool dest_changed() const = 0;
+
+            //Returns true if the target value still holds the default value applied by
+            //the last call to set_dest_to_default() (i.e. re-applying it can be skipped)
+            virtual bool dest_holds_default() const = 0;
+
+            //Appends the target value to a snapshot (see ArgumentParser::save_snapshot())
+            virtual void encode_dest(SnapshotWriter& writer) const = 0;
+
+            //Sets the target value from one written by encode_dest(), with the specified provenance
+            virtual void decode_dest(SnapshotReader& reader, Provenance prov) = 0;
+
+            //Returns the target value(s) converted to strings
+            virtual std::vector<std::string> dest_value_strs() const = 0;
+
+            //Returns true if the target value is equal to the default value
+            virtual bool dest_equals_default() const = 0;
+
+            //Returns true if the target value was last set by this argument (rather than
+            //by another argument sharing the same destination)
+            virtual bool dest_set_by_this() const = 0;
         public: //Accessors
 
             //Returns a discriptive name build from the long/short option
@@ -223,24 +692,27 @@ namespace argparse {
 
             //Returns the long option name (or positional name) for this argument.
             //Note that this may be a single-letter option if only a short option name was specified
-            std::string long_option() const;
+            const std::string& long_option() const;
 
             //Returns the short option name for this argument, note that this returns
             //the empty string if no short option is specified, or if only the short option
             //is specified.
-            std::string short_option() const;
+            const std::string& short_option() const;
 
             //Returns the help description for this option
-            std::string help() const;
+            const std::string& help() const;
 
             //Returns the number of arguments this option expects
             char nargs() const;
 
+            //Returns the exact number of values this option expects if nargs() is '0', '1' or 'N'
+            size_t num_values() const;
+
             //Returns the specified metavar for this option
-            std::string metavar() const;
+            const std::string& metavar() const;
 
             //Returns the list of valid choices for this option
-            std::vector<std::string> choices() const;
+            const std::vector<std::string>& choices() const;
 
             //Returns the action associated with this option
             Action action() const;
@@ -260,6 +732,16 @@ namespace argparse {
             //Returns true if this is a positional argument
             bool positional() const;
 
+            //Returns the provenance of the target value
+            virtual Provenance dest_provenance() const = 0;
+
+            //Returns a description of the target value's type (which is only meaningful within the same program)
+            virtual std::string dest_type() const = 0;
+
+            //Returns a human readable name of the type of the argument's value(s) (e.g. 'integer'),
+            //or an empty string if unknown
+            virtual std::string type_name() const = 0;
+
             //Returns true if the default_value() was set
             bool default_set() const;
 
@@ -273,7 +755,19 @@ namespace argparse {
             Argument& operator=(const Argument&&) = delete;
         protected:
             virtual bool valid_action() = 0;
+
+            //Returns the number of values the destination's type holds if fixed (e.g. std::array), otherwise 0
+            virtual size_t dest_arity() const { return 0; }
+
+            //Converts default_value_ to the target type, so it need not be re-converted on every parse
+            virtual void convert_default_value() = 0;
+
             std::vector<std::string> default_value_;
+            bool dest_holds_default_ = false;
+
+            //Interned name() and group_name(), recorded in the destination on each store
+            StringId name_id_ = EMPTY_STRING_ID;
+            StringId group_id_ = EMPTY_STRING_ID;
         private: //Data
             std::string long_opt_;
             std::string short_opt_;
@@ -281,6 +775,7 @@ namespace argparse {
             std::string help_;
             std::string metavar_;
             char nargs_ = '1';
+            size_t num_values_ = 1;
             std::vector<std::string> choices_;
             Action action_ = Action::STORE;
             bool required_ = false;
@@ -300,26 +795,25 @@ namespace argparse {
                 {}
         public: //Mutators
             void set_dest_to_default() override {
-                dest_.set(Converter().from_str(default_value()), Provenance::DEFAULT);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set(default_converted_, Provenance::DEFAULT);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = true;
             }
 
             void set_dest_to_value(std::string value) override {
-                if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() == name()) {
-                    throw ArgParseError("Argument " + name() + " specified multiple times");
-                }
-
+                dest_holds_default_ = false;
                 dest_.set(Converter().from_str(value), Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set_argument_ids(name_id_, group_id_);
             }
 
             void add_value_to_dest(std::string /*value*/) override {
                 throw ArgParseError("Single value option can not have multiple values set");
             }
 
+            void set_dest_to_values(const ValueStrs& /*values*/) override {
+                throw ArgParseError("Single value option can not have multiple values set");
+            }
+
             void set_dest_to_true() override {
                 throw ArgParseError("Non-boolean destination can not be set true");
             }
@@ -345,6 +839,46 @@ namespace argparse {
 
             void reset_dest() override {
                 dest_ = ArgValue<T>();
+                dest_holds_default_ = false;
+            }
+
+            bool dest_holds_default() const override {
+                return dest_holds_default_ && dest_.provenance() == Provenance::DEFAULT;
+            }
+
+            void snapshot_dest() override {
+                snapshot_value_.set(dest_.value());
+                snapshot_provenance_ = dest_.provenance();
+            }
+
+            bool dest_changed() const override {
+                return dest_.provenance() != snapshot_provenance_ || !snapshot_value_.equals(dest_.value());
+            }
+
+            void encode_dest(SnapshotWriter& writer) const override {
+                SnapshotCodec<T,Converter>::encode(writer, dest_.value());
+            }
+
+            void decode_dest(SnapshotReader& reader, Provenance prov) override {
+                dest_.set(SnapshotCodec<T,Converter>::decode(reader), prov);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = false;
+            }
+
+            Provenance dest_provenance() const override { return dest_.provenance(); }
+
+            bool dest_set_by_this() const override { return dest_.argument_name_id() == name_id_; }
+
+            std::string dest_type() const override { return typeid(T).name(); }
+
+            std::string type_name() const override { return arg_type<T>(); }
+
+            std::vector<std::string> dest_value_strs() const override {
+                return {converted_str(Converter().to_str(dest_.value()))};
+            }
+
+            bool dest_equals_default() const override {
+                return default_set() && default_converted_.valid() && values_equal(dest_.value(), default_converted_.value());
             }
 
             bool is_valid_value(std::string value) override {
@@ -356,8 +890,17 @@ namespace argparse {
                 return is_valid_choice(value, choices());
             }
 
+        protected:
+            void convert_default_value() override {
+                default_converted_ = Converter().from_str(default_value());
+                dest_holds_default_ = false;
+            }
+
         private: //Data
             ArgValue<T>& dest_;
+            ConvertedValue<T> default_converted_;
+            ValueSnapshot<T> snapshot_value_;
+            Provenance snapshot_provenance_ = Provenance::UNSPECIFIED;
     };
 
     //bool specialization for STORE_TRUE/STORE_FALSE
@@ -370,42 +913,41 @@ namespace argparse {
                 {}
         public: //Mutators
             void set_dest_to_default() override {
-                dest_.set(Converter().from_str(default_value()), Provenance::DEFAULT);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set(default_converted_, Provenance::DEFAULT);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = true;
             }
 
             void add_value_to_dest(std::string /*value*/) override {
                 throw ArgParseError("Single value option can not have multiple values set");
             }
 
-            void set_dest_to_value(std::string value) override {
-                if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() == name()) {
-                    throw ArgParseError("Argument " + name() + " specified multiple times");
-                }
+            void set_dest_to_values(const ValueStrs& /*values*/) override {
+                throw ArgParseError("Single value option can not have multiple values set");
+            }
 
+            void set_dest_to_value(std::string value) override {
+                dest_holds_default_ = false;
                 dest_.set(Converter().from_str(value), Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set_argument_ids(name_id_, group_id_);
             }
 
             void set_dest_to_true() override {
                 ConvertedValue<bool> val;
                 val.set_value(true);
 
+                dest_holds_default_ = false;
                 dest_.set(val, Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set_argument_ids(name_id_, group_id_);
             }
 
             void set_dest_to_false() override {
                 ConvertedValue<bool> val;
                 val.set_value(false);
 
+                dest_holds_default_ = false;
                 dest_.set(val, Provenance::SPECIFIED);
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set_argument_ids(name_id_, group_id_);
             }
 
             bool valid_action() override { 
@@ -415,6 +957,46 @@ namespace argparse {
 
             void reset_dest() override {
                 dest_ = ArgValue<bool>();
+                dest_holds_default_ = false;
+            }
+
+            bool dest_holds_default() const override {
+                return dest_holds_default_ && dest_.provenance() == Provenance::DEFAULT;
+            }
+
+            void snapshot_dest() override {
+                snapshot_value_.set(dest_.value());
+                snapshot_provenance_ = dest_.provenance();
+            }
+
+            bool dest_changed() const override {
+                return dest_.provenance() != snapshot_provenance_ || !snapshot_value_.equals(dest_.value());
+            }
+
+            void encode_dest(SnapshotWriter& writer) const override {
+                SnapshotCodec<bool,Converter>::encode(writer, dest_.value());
+            }
+
+            void decode_dest(SnapshotReader& reader, Provenance prov) override {
+                dest_.set(SnapshotCodec<bool,Converter>::decode(reader), prov);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = false;
+            }
+
+            Provenance dest_provenance() const override { return dest_.provenance(); }
+
+            bool dest_set_by_this() const override { return dest_.argument_name_id() == name_id_; }
+
+            std::string dest_type() const override { return typeid(bool).name(); }
+
+            std::string type_name() const override { return arg_type<bool>(); }
+
+            std::vector<std::string> dest_value_strs() const override {
+                return {converted_str(Converter().to_str(dest_.value()))};
+            }
+
+            bool dest_equals_default() const override {
+                return default_set() && default_converted_.valid() && dest_.value() == default_converted_.value();
             }
 
             bool is_valid_value(std::string value) override {
@@ -425,8 +1007,18 @@ namespace argparse {
                 }
                 return is_valid_choice(value, choices());
             }
+
+        protected:
+            void convert_default_value() override {
+                default_converted_ = Converter().from_str(default_value());
+                dest_holds_default_ = false;
+            }
+
         private: //Data
             ArgValue<bool>& dest_;
+            ConvertedValue<bool> default_converted_;
+            ValueSnapshot<bool> snapshot_value_;
+            Provenance snapshot_provenance_ = Provenance::UNSPECIFIED;
     };
 
     template<typename T, typename Converter>
@@ -439,14 +1031,9 @@ namespace argparse {
 
         public: //Mutators
             void set_dest_to_default() override {
-                auto& target = dest_.mutable_value(Provenance::DEFAULT);
-                for (auto default_str : default_value_) {
-                    auto val = Converter().from_str(default_str);
-                    target.insert(std::end(target), val.value());
-                }
-
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set(default_converted_, Provenance::DEFAULT);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = true;
             }
 
             void set_dest_to_value(std::string /*value*/) override {
@@ -455,12 +1042,13 @@ namespace argparse {
 
             void add_value_to_dest(std::string value) override {
                 if (dest_.provenance() == Provenance::SPECIFIED
-                    && dest_.argument_name() != name()) {
+                    && dest_.argument_name_id() != name_id_) {
                     throw ArgParseError("Argument destination already set by " + dest_.argument_name() + " (trying to set from " + name() + ")");
                 }
 
                 auto previous_provenance = dest_.provenance();
 
+                dest_holds_default_ = false;
                 auto& target = dest_.mutable_value(Provenance::SPECIFIED);
 
                 if (previous_provenance == Provenance::DEFAULT) {
@@ -472,10 +1060,15 @@ namespace argparse {
                 if (!converted_value) {
                     throw ArgParseConversionError(converted_value.error());
                 }
-                target.insert(std::end(target), converted_value.value());
+                target.insert(std::end(target), std::move(converted_value).value());
 
-                dest_.set_argument_name(name());
-                dest_.set_argument_group(group_name());
+                dest_.set_argument_ids(name_id_, group_id_);
+            }
+
+            void set_dest_to_values(const ValueStrs& values) override {
+                for (size_t i = 0; i < values.size(); ++i) {
+                    add_value_to_dest(values[i]);
+                }
             }
 
             void set_dest_to_true() override {
@@ -495,6 +1088,58 @@ namespace argparse {
 
             void reset_dest() override {
                 dest_ = ArgValue<T>();
+                dest_holds_default_ = false;
+            }
+
+            bool dest_holds_default() const override {
+                return dest_holds_default_ && dest_.provenance() == Provenance::DEFAULT;
+            }
+
+            void snapshot_dest() override {
+                snapshot_value_.set(dest_.value());
+                snapshot_provenance_ = dest_.provenance();
+            }
+
+            bool dest_changed() const override {
+                return dest_.provenance() != snapshot_provenance_ || !snapshot_value_.equals(dest_.value());
+            }
+
+            void encode_dest(SnapshotWriter& writer) const override {
+                writer.write_pod<uint32_t>(dest_.value().size());
+                for (const auto& value : dest_.value()) {
+                    SnapshotCodec<typename T::value_type,Converter>::encode(writer, value);
+                }
+            }
+
+            void decode_dest(SnapshotReader& reader, Provenance prov) override {
+                uint32_t num_values = reader.read_pod<uint32_t>();
+                T values;
+                for (uint32_t i = 0; i < num_values; ++i) {
+                    values.insert(std::end(values), SnapshotCodec<typename T::value_type,Converter>::decode(reader));
+                }
+                dest_.set(std::move(values), prov);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = false;
+            }
+
+            Provenance dest_provenance() const override { return dest_.provenance(); }
+
+            bool dest_set_by_this() const override { return dest_.argument_name_id() == name_id_; }
+
+            std::string dest_type() const override { return typeid(T).name(); }
+
+            std::string type_name() const override { return arg_type<typename T::value_type>(); }
+
+            std::vector<std::string> dest_value_strs() const override {
+                std::vector<std::string> strs;
+                for (const auto& value : dest_.value()) {
+                    strs.push_back(converted_str(Converter().to_str(value)));
+                }
+                return strs;
+            }
+
+            bool dest_equals_default() const override {
+                return default_set() && default_converted_.valid() && values_equal(dest_.value(), default_converted_.value());
             }
 
             bool is_valid_value(std::string value) override {
@@ -505,11 +1150,261 @@ namespace argparse {
                 }
                 return is_valid_choice(value, choices());
             }
+
+        protected:
+            void convert_default_value() override {
+                T values;
+                for (const auto& default_str : default_value_) {
+                    auto converted_value = Converter().from_str(default_str);
+                    if (!converted_value) {
+                        default_converted_.set_error(converted_value.error());
+                        return;
+                    }
+                    //Insert is more general than push_back
+                    values.insert(std::end(values), std::move(converted_value).value());
+                }
+                default_converted_.set_value(std::move(values));
+                dest_holds_default_ = false;
+            }
+
         private: //Data
             ArgValue<T>& dest_;
+            ConvertedValue<T> default_converted_;
+            ValueSnapshot<T> snapshot_value_;
+            Provenance snapshot_provenance_ = Provenance::UNSPECIFIED;
     };
 
 
+    //Converter for element I of a fixed arity destination: Converter for each element of a
+    //std::array, and the default conversion of each element's type for a std::tuple
+    template<typename T, size_t I, typename Converter>
+    struct FixedArityElementConverter {
+        typedef Converter type;
+    };
+
+    template<typename... Ts, size_t I>
+    struct FixedArityElementConverter<std::tuple<Ts...>, I, void> {
+        typedef DefaultConverter<typename std::tuple_element<I, std::tuple<Ts...>>::type> type;
+    };
+
+    /*
+     * FixedArityArgument stores exactly ARITY values into a std::array or std::tuple (nargs 'N')
+     *
+     * Each value is converted directly into its element of a temporary, which is moved into the
+     * destination once all have converted, so no container is allocated while parsing.
+     */
+    template<typename T, typename Converter>
+    class FixedArityArgument : public Argument {
+        public:
+            static constexpr size_t ARITY = std::tuple_size<T>::value;
+            static_assert(ARITY > 0, "Fixed arity destinations must hold at least one value");
+
+        public: //Constructors
+            FixedArityArgument(ArgValue<T>& dest, std::string long_opt, std::string short_opt)
+                : Argument(long_opt, short_opt)
+                , dest_(dest) {
+                nargs(int(ARITY));
+            }
+
+        public: //Mutators
+            void set_dest_to_default() override {
+                dest_.set(default_converted_, Provenance::DEFAULT);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = true;
+            }
+
+            void set_dest_to_value(std::string value) override {
+                if (ARITY != 1) {
+                    throw ArgParseError("Fixed arity option can not be set to a single value");
+                }
+                std::string values[1] = {value};
+                set_dest_to_values(ValueStrs(nullptr, values, 1));
+            }
+
+            void add_value_to_dest(std::string /*value*/) override {
+                throw ArgParseError("Fixed arity option can not have values added");
+            }
+
+            void set_dest_to_values(const ValueStrs& values) override {
+                if (values.size() != ARITY) {
+                    std::stringstream msg;
+                    msg << "Expected " << ARITY << " values (found " << values.size() << ")";
+                    throw ArgParseConversionError(msg.str());
+                }
+                T converted;
+                convert_elements<0>(values, converted);
+
+                dest_holds_default_ = false;
+                dest_.set(std::move(converted), Provenance::SPECIFIED);
+                dest_.set_argument_ids(name_id_, group_id_);
+            }
+
+            void set_dest_to_true() override {
+                throw ArgParseError("Non-boolean destination can not be set true");
+            }
+            void set_dest_to_false() override {
+                throw ArgParseError("Non-boolean destination can not be set false");
+            }
+
+            bool valid_action() override {
+                //Sanity check that we aren't processing a boolean action with a non-boolean destination
+                if (action() != Action::STORE) {
+                    throw ArgParseError("Unexpected action (expected STORE)");
+                }
+                return true;
+            }
+
+            void reset_dest() override {
+                dest_ = ArgValue<T>();
+                dest_holds_default_ = false;
+            }
+
+            bool dest_holds_default() const override {
+                return dest_holds_default_ && dest_.provenance() == Provenance::DEFAULT;
+            }
+
+            void snapshot_dest() override {
+                snapshot_value_.set(dest_.value());
+                snapshot_provenance_ = dest_.provenance();
+            }
+
+            bool dest_changed() const override {
+                return dest_.provenance() != snapshot_provenance_ || !snapshot_value_.equals(dest_.value());
+            }
+
+            void encode_dest(SnapshotWriter& writer) const override {
+                encode_elements<0>(writer, dest_.value());
+            }
+
+            void decode_dest(SnapshotReader& reader, Provenance prov) override {
+                T values;
+                decode_elements<0>(reader, values);
+                dest_.set(std::move(values), prov);
+                dest_.set_argument_ids(name_id_, group_id_);
+                dest_holds_default_ = false;
+            }
+
+            Provenance dest_provenance() const override { return dest_.provenance(); }
+
+            bool dest_set_by_this() const override { return dest_.argument_name_id() == name_id_; }
+
+            std::string dest_type() const override { return typeid(T).name(); }
+
+            std::string type_name() const override {
+                //A single name if all elements share it (e.g. 'float' for std::array<float,4>)
+                std::vector<std::string> names;
+                element_type_names<0>(names);
+                if (std::all_of(names.begin(), names.end(), [&](const std::string& name_str) { return name_str == names[0]; })) {
+                    return names[0];
+                }
+                return join(names, ", ");
+            }
+
+            std::vector<std::string> dest_value_strs() const override {
+                std::vector<std::string> strs;
+                element_strs<0>(dest_.value(), strs);
+                return strs;
+            }
+
+            bool dest_equals_default() const override {
+                return default_set() && default_converted_.valid() && values_equal(dest_.value(), default_converted_.value());
+            }
+
+            bool is_valid_value(std::string value) override {
+                //Values are only checked against the choices, since which element a value
+                //converts to depends on its position (conversion errors are reported when setting)
+                return is_valid_choice(value, choices());
+            }
+
+        protected:
+            size_t dest_arity() const override { return ARITY; }
+
+            void convert_default_value() override {
+                if (default_value_.size() != ARITY) {
+                    std::stringstream msg;
+                    msg << "Expected " << ARITY << " default values (found " << default_value_.size() << ")";
+                    default_converted_.set_error(msg.str());
+                    return;
+                }
+                T values;
+                try {
+                    convert_elements<0>(ValueStrs(nullptr, default_value_.data(), default_value_.size()), values);
+                } catch (const ArgParseConversionError& e) {
+                    default_converted_.set_error(e.what());
+                    return;
+                }
+                default_converted_.set_value(std::move(values));
+                dest_holds_default_ = false;
+            }
+
+        private:
+            template<size_t I>
+            using ElementType = typename std::tuple_element<I, T>::type;
+
+            template<size_t I>
+            using ElementConverter = typename FixedArityElementConverter<T, I, Converter>::type;
+
+            template<size_t I>
+            static typename std::enable_if<(I < ARITY)>::type convert_elements(const ValueStrs& values, T& converted) {
+                auto converted_value = ElementConverter<I>().from_str(values[I]);
+                if (!converted_value) {
+                    throw ArgParseConversionError(converted_value.error());
+                }
+                std::get<I>(converted) = std::move(converted_value).value();
+                convert_elements<I + 1>(values, converted);
+            }
+            template<size_t I>
+            static typename std::enable_if<(I == ARITY)>::type convert_elements(const ValueStrs& /*values*/, T& /*converted*/) {}
+
+            template<size_t I>
+            static typename std::enable_if<(I < ARITY)>::type encode_elements(SnapshotWriter& writer, const T& values) {
+                SnapshotCodec<ElementType<I>, ElementConverter<I>>::encode(writer, std::get<I>(values));
+                encode_elements<I + 1>(writer, values);
+            }
+            template<size_t I>
+            static typename std::enable_if<(I == ARITY)>::type encode_elements(SnapshotWriter& /*writer*/, const T& /*values*/) {}
+
+            template<size_t I>
+            static typename std::enable_if<(I < ARITY)>::type decode_elements(SnapshotReader& reader, T& values) {
+                std::get<I>(values) = SnapshotCodec<ElementType<I>, ElementConverter<I>>::decode(reader);
+                decode_elements<I + 1>(reader, values);
+            }
+            template<size_t I>
+            static typename std::enable_if<(I == ARITY)>::type decode_elements(SnapshotReader& /*reader*/, T& /*values*/) {}
+
+            template<size_t I>
+            static typename std::enable_if<(I < ARITY)>::type element_strs(const T& values, std::vector<std::string>& strs) {
+                strs.push_back(converted_str(ElementConverter<I>().to_str(std::get<I>(values))));
+                element_strs<I + 1>(values, strs);
+            }
+            template<size_t I>
+            static typename std::enable_if<(I == ARITY)>::type element_strs(const T& /*values*/, std::vector<std::string>& /*strs*/) {}
+
+            template<size_t I>
+            static typename std::enable_if<(I < ARITY)>::type element_type_names(std::vector<std::string>& names) {
+                names.push_back(arg_type<ElementType<I>>());
+                element_type_names<I + 1>(names);
+            }
+            template<size_t I>
+            static typename std::enable_if<(I == ARITY)>::type element_type_names(std::vector<std::string>& /*names*/) {}
+
+        private: //Data
+            ArgValue<T>& dest_;
+            ConvertedValue<T> default_converted_;
+            ValueSnapshot<T> snapshot_value_;
+            Provenance snapshot_provenance_ = Provenance::UNSPECIFIED;
+    };
+
+    template<typename T, typename Converter>
+    constexpr size_t FixedArityArgument<T, Converter>::ARITY;
+
+
+    //Entry point for a build-time generator of pre-rendered help (see argparse_prerender_help() in
+    //CMakeLists.txt), called with the generator's command-line and the fully defined parser. Expects the
+    //arguments '<output.cpp> <variable_name> [prog]', and writes the parser's help (with prog as the program
+    //name, if specified) to output.cpp, leaving it untouched if unchanged. Returns the process exit code.
+    int prerender_help_main(int argc, const char* const* argv, ArgumentParser& parser);
+
 } //namespace
 
 #include "argparse.tpp"
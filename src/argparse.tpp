@@ -4,8 +4,10 @@
 namespace argparse {
 
     template<typename T, typename Converter>
-    std::shared_ptr<Argument> make_singlevalue_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        auto ptr = std::make_shared<SingleValueArgument<T, Converter>>(dest, long_opt, short_opt);
+    std::shared_ptr<Argument> make_singlevalue_argument(MemoryResource* resource, ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
+        //The argument and its reference count share a single allocation from resource
+        PolymorphicAllocator<SingleValueArgument<T, Converter>> alloc(resource);
+        auto ptr = std::allocate_shared<SingleValueArgument<T, Converter>>(alloc, dest, long_opt, short_opt);
 
         //If the conversion object specifies a non-empty set of choices
         //use those by default
@@ -18,8 +20,10 @@ namespace argparse {
     }
 
     template<typename T, typename Converter>
-    std::shared_ptr<Argument> make_multivalue_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        auto ptr = std::make_shared<MultiValueArgument<T, Converter>>(dest, long_opt, short_opt);
+    std::shared_ptr<Argument> make_multivalue_argument(MemoryResource* resource, ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
+        //The argument and its reference count share a single allocation from resource
+        PolymorphicAllocator<MultiValueArgument<T, Converter>> alloc(resource);
+        auto ptr = std::allocate_shared<MultiValueArgument<T, Converter>>(alloc, dest, long_opt, short_opt);
 
         //If the conversion object specifies a non-empty set of choices
         //use those by default
@@ -31,6 +35,13 @@ namespace argparse {
         return ptr;
     }
 
+    template<typename T, typename Converter>
+    std::shared_ptr<Argument> make_fixed_arity_argument(MemoryResource* resource, ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
+        //The argument and its reference count share a single allocation from resource
+        PolymorphicAllocator<FixedArityArgument<T, Converter>> alloc(resource);
+        return std::allocate_shared<FixedArityArgument<T, Converter>>(alloc, dest, long_opt, short_opt);
+    }
+
     /*
      * ArgumentParser
      */
@@ -54,6 +65,27 @@ namespace argparse {
     Argument& ArgumentParser::add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt) {
         return argument_groups_[0].add_argument<T,Converter>(dest, long_opt, short_opt);
     }
+
+    template<typename T, size_t N, typename Converter>
+    Argument& ArgumentParser::add_argument(ArgValue<std::array<T,N>>& dest, std::string option) {
+        return add_argument<T,N,Converter>(dest, option, std::string());
+    }
+
+    template<typename T, size_t N, typename Converter>
+    Argument& ArgumentParser::add_argument(ArgValue<std::array<T,N>>& dest, std::string long_opt, std::string short_opt) {
+        return argument_groups_[0].add_argument<T,N,Converter>(dest, long_opt, short_opt);
+    }
+
+    template<typename... Ts>
+    Argument& ArgumentParser::add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string option) {
+        return add_argument(dest, option, std::string());
+    }
+
+    template<typename... Ts>
+    Argument& ArgumentParser::add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string long_opt, std::string short_opt) {
+        return argument_groups_[0].add_argument(dest, long_opt, short_opt);
+    }
+
     /*
      * ArgumentGroup
      */
@@ -64,7 +96,7 @@ namespace argparse {
 
     template<typename T, typename Converter>
     Argument& ArgumentGroup::add_argument(ArgValue<T>& dest, std::string long_opt, std::string short_opt) {
-        arguments_.push_back(make_singlevalue_argument<T,Converter>(dest, long_opt, short_opt));
+        arguments_.push_back(make_singlevalue_argument<T,Converter>(arguments_.get_allocator().resource(), dest, long_opt, short_opt));
 
         auto& arg = arguments_[arguments_.size() - 1];
         arg->group_name(name()); //Tag the option with the group
@@ -78,7 +110,43 @@ namespace argparse {
 
     template<typename T, typename Converter>
     Argument& ArgumentGroup::add_argument(ArgValue<std::vector<T>>& dest, std::string long_opt, std::string short_opt) {
-        arguments_.push_back(make_multivalue_argument<std::vector<T>,Converter>(dest, long_opt, short_opt));
+        arguments_.push_back(make_multivalue_argument<std::vector<T>,Converter>(arguments_.get_allocator().resource(), dest, long_opt, short_opt));
+
+        auto& arg = arguments_[arguments_.size() - 1];
+        arg->group_name(name()); //Tag the option with the group
+        return *arg;
+    }
+
+    template<typename T, size_t N, typename Converter>
+    Argument& ArgumentGroup::add_argument(ArgValue<std::array<T,N>>& dest, std::string option) {
+        return add_argument<T,N,Converter>(dest, option, std::string());
+    }
+
+    template<typename T, size_t N, typename Converter>
+    Argument& ArgumentGroup::add_argument(ArgValue<std::array<T,N>>& dest, std::string long_opt, std::string short_opt) {
+        arguments_.push_back(make_fixed_arity_argument<std::array<T,N>,Converter>(arguments_.get_allocator().resource(), dest, long_opt, short_opt));
+
+        auto& arg = arguments_[arguments_.size() - 1];
+        arg->group_name(name()); //Tag the option with the group
+
+        //If the conversion object specifies a non-empty set of choices
+        //use those by default
+        auto default_choices = Converter().default_choices();
+        if (!default_choices.empty()) {
+            arg->choices(default_choices);
+        }
+        return *arg;
+    }
+
+    template<typename... Ts>
+    Argument& ArgumentGroup::add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string option) {
+        return add_argument(dest, option, std::string());
+    }
+
+    template<typename... Ts>
+    Argument& ArgumentGroup::add_argument(ArgValue<std::tuple<Ts...>>& dest, std::string long_opt, std::string short_opt) {
+        //Each element uses its type's default conversion
+        arguments_.push_back(make_fixed_arity_argument<std::tuple<Ts...>,void>(arguments_.get_allocator().resource(), dest, long_opt, short_opt));
 
         auto& arg = arguments_[arguments_.size() - 1];
         arg->group_name(name()); //Tag the option with the group
@@ -0,0 +1,339 @@
+#include <cassert>
+#include <cctype>
+#include <limits>
+#include <sstream>
+
+#include "argparse.hpp"
+#include "argparse_util.hpp"
+
+namespace argparse {
+
+    namespace {
+        std::vector<std::string> filter_prefix(const std::vector<std::string>& candidates, const std::string& prefix, const std::string& add_prefix);
+        std::string completion_field(std::string str);
+        std::string shell_identifier(const std::string& str);
+        std::string shell_quote(const std::string& str, CompletionShell shell);
+        std::string shell_words(const std::vector<std::string>& words, CompletionShell shell);
+    }
+
+    std::vector<std::string> ArgumentParser::complete(std::vector<std::string> arg_strs, size_t cursor) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        if (cursor > arg_strs.size()) {
+            cursor = arg_strs.size();
+        }
+        std::string word;
+        if (cursor < arg_strs.size()) {
+            word = arg_strs[cursor];
+        }
+
+        //Determine what the words before the cursor have consumed
+        size_t num_positional_args = 0;
+        for (const auto& arg : arguments_) {
+            if (arg->positional()) {
+                ++num_positional_args;
+            }
+        }
+
+        constexpr size_t UNBOUNDED = std::numeric_limits<size_t>::max();
+        std::shared_ptr<Argument> value_arg; //Option whose values are being specified
+        size_t values_remaining = 0;
+        size_t num_positionals = 0;
+        for (size_t i = 0; i < cursor; ++i) {
+            OptionMatch match;
+            try {
+                match = match_option(arg_strs[i]);
+            } catch (const ArgParseError&) {
+                //Ambiguous or malformed option, treat as unrecognized
+            }
+
+            if (match.arg) {
+                value_arg = nullptr;
+                values_remaining = 0;
+                if (match.arg->action() == Action::STORE) {
+                    value_arg = match.arg;
+                    if (match.arg->nargs() == '1' || match.arg->nargs() == 'N') {
+                        values_remaining = match.arg->num_values() - (match.has_attached_value ? 1 : 0);
+                    } else {
+                        values_remaining = UNBOUNDED;
+                    }
+                }
+            } else if (value_arg && values_remaining > 0) {
+                if (values_remaining != UNBOUNDED) {
+                    --values_remaining;
+                }
+            } else if (num_positionals == num_positional_args && subparsers_ && subparsers_->find(arg_strs[i])) {
+                //The remaining words belong to the subcommand
+                return subcommand_parser(arg_strs[i]).complete(std::vector<std::string>(arg_strs.begin() + i + 1, arg_strs.end()),
+                                                               cursor - i - 1);
+            } else {
+                value_arg = nullptr;
+                ++num_positionals;
+            }
+        }
+
+        bool word_is_option = word.size() > 0 && word[0] == '-';
+
+        if (value_arg && values_remaining > 0 && (values_remaining != UNBOUNDED || !word_is_option)) {
+            //A value for the preceeding option
+            return filter_prefix(value_arg->choices(), word, "");
+        }
+
+        if (word_is_option) {
+            std::string value;
+            auto arg = option_index_.find_with_attached_value(word, value);
+            if (arg) {
+                //A value attached to a long option (e.g. '--foo=ba')
+                std::string opt(word, 0, word.size() - value.size());
+                return filter_prefix(arg->choices(), value, opt);
+            }
+            return option_index_.options_with_prefix(StrRef(word));
+        }
+
+        //A positional argument
+        for (const auto& arg : arguments_) {
+            if (!arg->positional()) continue;
+
+            if (num_positionals == 0) {
+                return filter_prefix(arg->choices(), word, "");
+            }
+            --num_positionals;
+        }
+
+        if (num_positionals == 0 && subparsers_) {
+            return filter_prefix(subparsers_->names(), word, "");
+        }
+        return {};
+    }
+
+    void ArgumentParser::write_completion_cache(std::ostream& os) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        for (const auto& arg : arguments_) {
+            if (arg->positional()) continue;
+
+            for (const auto& opt : {arg->long_option(), arg->short_option()}) {
+                if (opt.empty()) continue;
+
+                os << opt << "\t" << arg->nargs()
+                   << "\t" << completion_field(join(arg->choices(), " "))
+                   << "\t" << completion_field(arg->help()) << "\n";
+            }
+        }
+    }
+
+    std::string ArgumentParser::completion_script(CompletionShell shell, std::string cache_file) {
+        std::string func = "_argparse_" + shell_identifier(prog());
+        std::string quoted_prog = shell_quote(prog(), shell);
+
+        std::stringstream ss;
+        if (shell == CompletionShell::BASH || shell == CompletionShell::ZSH) {
+            if (shell == CompletionShell::ZSH) {
+                //zsh runs the bash completion function through its emulation layer
+                ss << "autoload -U +X bashcompinit && bashcompinit\n";
+            }
+            write_bash_completion(ss, func + "_words");
+            ss << func << "() {\n";
+            ss << "    " << func << "_words 1\n";
+            ss << "}\n";
+            ss << "complete -F " << func << " " << quoted_prog << "\n";
+        } else {
+            assert(shell == CompletionShell::FISH);
+            std::string quoted_cache = shell_quote(cache_file, shell);
+            ss << "complete -c " << quoted_prog << " -e\n";
+            ss << "if test -r " << quoted_cache << "\n";
+            ss << "    while read -l line\n";
+            ss << "        set -l fields (string split \\t -- $line)\n";
+            ss << "        set -l args -c " << quoted_prog << " -d \"$fields[4]\"\n";
+            ss << "        if string match -q -- '--*' $fields[1]\n";
+            ss << "            set args $args -l (string sub -s 3 -- $fields[1])\n";
+            ss << "        else if test (string length -- $fields[1]) -eq 2\n";
+            ss << "            set args $args -s (string sub -s 2 -- $fields[1])\n";
+            ss << "        else\n";
+            ss << "            set args $args -o (string sub -s 2 -- $fields[1])\n";
+            ss << "        end\n";
+            ss << "        if test $fields[2] != 0\n";
+            ss << "            set args $args -r\n";
+            ss << "            if test -n \"$fields[3]\"\n";
+            ss << "                set args $args -f -a $fields[3]\n";
+            ss << "            end\n";
+            ss << "        end\n";
+            ss << "        complete $args\n";
+            ss << "    end < " << quoted_cache << "\n";
+            ss << "end\n";
+            if (subparsers_) {
+                for (const auto& name : subparsers_->names()) {
+                    ss << "complete -c " << quoted_prog << " -f -n __fish_use_subcommand -a " << shell_quote(name, shell)
+                       << " -d " << shell_quote(completion_field(subparsers_->help(name)), shell) << "\n";
+                }
+            }
+        }
+        return ss.str();
+    }
+
+    void ArgumentParser::write_bash_completion(std::ostream& os, const std::string& func) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        constexpr CompletionShell BASH = CompletionShell::BASH;
+
+        //Group the option strings by the number of values they take (-1 if unbounded, 0 for flags),
+        //and collect the choices of each option and positional argument
+        std::map<int, std::vector<std::string>> opts_by_num_values;
+        std::vector<std::pair<std::string, std::vector<std::string>>> opt_choices; //Pattern and choices
+        std::vector<std::vector<std::string>> positional_choices;
+        std::vector<std::string> sorted_opts;
+        for (const auto& arg : arguments_) {
+            if (arg->positional()) {
+                positional_choices.push_back(arg->choices());
+                continue;
+            }
+
+            std::vector<std::string> quoted_opts;
+            for (const auto& opt : {arg->long_option(), arg->short_option()}) {
+                if (opt.empty()) continue;
+                sorted_opts.push_back(opt);
+                quoted_opts.push_back(shell_quote(opt, BASH));
+            }
+            int num_values = 0;
+            if (arg->action() == Action::STORE) {
+                num_values = (arg->nargs() == '1' || arg->nargs() == 'N') ? static_cast<int>(arg->num_values()) : -1;
+            }
+            auto& opts = opts_by_num_values[num_values];
+            opts.insert(opts.end(), quoted_opts.begin(), quoted_opts.end());
+            if (num_values != 0 && !arg->choices().empty()) {
+                opt_choices.emplace_back(join(quoted_opts, "|"), arg->choices());
+            }
+        }
+        std::sort(sorted_opts.begin(), sorted_opts.end());
+
+        std::vector<std::string> subcommands;
+        if (subparsers_) {
+            subcommands = subparsers_->names();
+        }
+
+        //Track the option whose values are being specified (nvals remaining, or -1 if unbounded) and
+        //the number of positional arguments, over the words before the cursor (a word '=' joins an
+        //option to its attached value, since bash splits words at '=')
+        os << func << "() {\n";
+        os << "    local cur=\"${COMP_WORDS[COMP_CWORD]}\"\n";
+        os << "    local word opt='' nvals=0 npos=0 i\n";
+        os << "    [[ \"$cur\" == = ]] && cur=''\n";
+        os << "    for (( i = $1; i < COMP_CWORD; ++i )); do\n";
+        os << "        word=\"${COMP_WORDS[i]}\"\n";
+        os << "        case \"$word\" in\n";
+        os << "            =) ;;\n";
+        for (const auto& kv : opts_by_num_values) {
+            os << "            " << join(kv.second, "|") << ") opt=\"$word\"; nvals=" << kv.first << " ;;\n";
+        }
+        os << "            -*) (( nvals > 0 )) && (( --nvals )) ;;\n";
+        os << "            *)\n";
+        os << "                if (( nvals > 0 )); then\n";
+        os << "                    (( --nvals ))\n";
+        os << "                elif (( nvals == 0 )); then\n";
+        if (!subcommands.empty()) {
+            os << "                    if (( npos == " << positional_choices.size() << " )); then\n";
+            os << "                        case \"$word\" in\n";
+            for (const auto& name : subcommands) {
+                os << "                            " << shell_quote(name, BASH) << ") "
+                   << func << "_" << shell_identifier(name) << " $(( i + 1 )); return ;;\n";
+            }
+            os << "                        esac\n";
+            os << "                    fi\n";
+        }
+        os << "                    (( ++npos ))\n";
+        os << "                fi ;;\n";
+        os << "        esac\n";
+        os << "    done\n";
+
+        //Complete a value of that option, an option, or a positional argument (or subcommand)
+        os << "    if (( nvals > 0 )) || [[ $nvals -lt 0 && \"$cur\" != -* ]]; then\n";
+        os << "        case \"$opt\" in\n";
+        for (const auto& choices : opt_choices) {
+            os << "            " << choices.first << ") COMPREPLY=( $(compgen -W " << shell_words(choices.second, BASH) << " -- \"$cur\") ) ;;\n";
+        }
+        os << "            *) COMPREPLY=( $(compgen -f -- \"$cur\") ) ;;\n";
+        os << "        esac\n";
+        os << "    elif [[ \"$cur\" == -* ]]; then\n";
+        os << "        COMPREPLY=( $(compgen -W " << shell_words(sorted_opts, BASH) << " -- \"$cur\") )\n";
+        os << "    else\n";
+        os << "        case \"$npos\" in\n";
+        for (size_t ipos = 0; ipos < positional_choices.size(); ++ipos) {
+            if (positional_choices[ipos].empty()) continue;
+            os << "            " << ipos << ") COMPREPLY=( $(compgen -W " << shell_words(positional_choices[ipos], BASH) << " -- \"$cur\") ) ;;\n";
+        }
+        if (!subcommands.empty()) {
+            os << "            " << positional_choices.size() << ") COMPREPLY=( $(compgen -W " << shell_words(subcommands, BASH) << " -- \"$cur\") ) ;;\n";
+        }
+        os << "            *) COMPREPLY=( $(compgen -f -- \"$cur\") ) ;;\n";
+        os << "        esac\n";
+        os << "    fi\n";
+        os << "}\n";
+
+        for (const auto& name : subcommands) {
+            subcommand_parser(name).write_bash_completion(os, func + "_" + shell_identifier(name));
+        }
+    }
+
+    /*
+     * Utilities
+     */
+    namespace {
+        std::vector<std::string> filter_prefix(const std::vector<std::string>& candidates, const std::string& prefix, const std::string& add_prefix) {
+            std::vector<std::string> matches;
+            for (const auto& candidate : candidates) {
+                if (candidate.compare(0, prefix.size(), prefix) == 0) {
+                    matches.push_back(add_prefix + candidate);
+                }
+            }
+            return matches;
+        }
+
+        //Returns str as a single line without tabs, so it can be stored as a field in the completion cache
+        std::string completion_field(std::string str) {
+            for (auto& c : str) {
+                if (c == '\t' || c == '\n') {
+                    c = ' ';
+                }
+            }
+            return str;
+        }
+
+        //Returns str with any characters not valid in a shell function name replaced
+        std::string shell_identifier(const std::string& str) {
+            std::string ident = str;
+            for (auto& c : ident) {
+                if (!std::isalnum(static_cast<unsigned char>(c))) {
+                    c = '_';
+                }
+            }
+            return ident;
+        }
+
+        //Returns str single-quoted for shell, so it is taken literally as one word. Embedded
+        //quotes close the quoting, add an escaped quote and re-open it. Fish also treats
+        //backslashes within single quotes as escapes, so they are escaped too.
+        std::string shell_quote(const std::string& str, CompletionShell shell) {
+            std::string quoted = "'";
+            for (char c : str) {
+                if (c == '\'') {
+                    quoted += "'\\''";
+                } else if (c == '\\' && shell == CompletionShell::FISH) {
+                    quoted += "\\\\";
+                } else {
+                    quoted += c;
+                }
+            }
+            quoted += "'";
+            return quoted;
+        }
+
+        //Returns words joined and quoted as a single shell word, as for compgen -W
+        std::string shell_words(const std::vector<std::string>& words, CompletionShell shell) {
+            return shell_quote(join(words, " "), shell);
+        }
+    }
+
+} //namespace
@@ -19,9 +19,19 @@ arg_type() { return "integer"; }
 
 //Unsigned Integer
 template<typename T>
-typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, std::string>::type
+typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T,bool>::value, std::string>::type
 arg_type() { return "non-negative integer"; }
 
+//Boolean
+template<typename T>
+typename std::enable_if<std::is_same<T,bool>::value, std::string>::type
+arg_type() { return "boolean"; }
+
+//String
+template<typename T>
+typename std::enable_if<std::is_same<T,std::string>::value, std::string>::type
+arg_type() { return "string"; }
+
 //Float
 template<typename T>
 typename std::enable_if<std::is_floating_point<T>::value, std::string>::type
@@ -29,7 +39,7 @@ arg_type() { return "float"; }
 
 //Unkown
 template<typename T>
-typename std::enable_if<!std::is_floating_point<T>::value && !std::is_integral<T>::value, std::string>::type
+typename std::enable_if<!std::is_floating_point<T>::value && !std::is_integral<T>::value && !std::is_same<T,std::string>::value, std::string>::type
 arg_type() { return ""; } //Empty
 
 /*
@@ -69,7 +79,7 @@ class DefaultConverter {
             std::stringstream ss;
             ss << val;
 
-            bool converted_ok = ss.eof() && !ss.fail();
+            bool converted_ok = !ss.fail();
 
             ConvertedValue<std::string> converted_value;
             if (!converted_ok) {
@@ -136,36 +146,38 @@ class DefaultConverter<std::string> {
 };
 
 //DefaultConverter specializations for const char*
-//  This allocates memory that the user is responsible for freeing
+//  During a parse values are stored in the parser's string arena, and remain valid until
+//  the next parse or ArgumentParser::reset_destinations(). Otherwise (e.g. for default
+//  values) this allocates memory that the user is responsible for freeing
 template<>
 class DefaultConverter<const char*> {
     public:
         ConvertedValue<const char*> from_str(std::string str) { 
             ConvertedValue<const char*> val;
-            val.set_value(strdup(str.c_str()));
+            val.set_value(arena_strdup(str));
             return val;
         }
         ConvertedValue<std::string> to_str(const char* val) {
             ConvertedValue<std::string> converted_value;
-            converted_value.set_value(val);
+            converted_value.set_value(val ? val : ""); //Unset destinations are null
             return converted_value;
         }
         std::vector<std::string> default_choices() { return {}; }
 };
 
 //DefaultConverter specializations for char*
-//  This allocates memory that the user is responsible for freeing
+//  Values are stored as for DefaultConverter<const char*>
 template<>
 class DefaultConverter<char*> {
     public:
         ConvertedValue<char*> from_str(std::string str) { 
             ConvertedValue<char*> val;
-            val.set_value(strdup(str.c_str()));
+            val.set_value(arena_strdup(str));
             return val;
         }
         ConvertedValue<std::string> to_str(const char* val) {
             ConvertedValue<std::string> converted_value;
-            converted_value.set_value(val);
+            converted_value.set_value(val ? val : ""); //Unset destinations are null
             return converted_value;
         }
         std::vector<std::string> default_choices() { return {}; }
@@ -0,0 +1,94 @@
+#include <cassert>
+#include <ostream>
+#include <streambuf>
+
+#include "argparse.hpp"
+#include "argparse_json.hpp"
+
+namespace argparse {
+
+    void write_csv_field(std::ostream& os, const std::string& str);
+
+    namespace {
+        //Appends all characters written to it to a string
+        class StringAppendStreambuf : public std::streambuf {
+            public:
+                StringAppendStreambuf(std::string& buf) : buf_(buf) {}
+            protected:
+                int_type overflow(int_type c) override {
+                    if (c != traits_type::eof()) {
+                        buf_.push_back(traits_type::to_char_type(c));
+                    }
+                    return traits_type::not_eof(c);
+                }
+
+                std::streamsize xsputn(const char* s, std::streamsize n) override {
+                    buf_.append(s, n);
+                    return n;
+                }
+            private:
+                std::string& buf_;
+        };
+    }
+
+    void ArgumentParser::dump_values(std::ostream& os, ValueDumpFormat format) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        if (format == ValueDumpFormat::CSV) {
+            os << "name,value,provenance,group\n";
+        }
+
+        for (const auto& arg : arguments_) {
+            if (arg->action() == Action::HELP || arg->action() == Action::VERSION) continue;
+
+            auto values = arg->dest_value_strs();
+            if (format == ValueDumpFormat::JSON_LINES) {
+                JsonWriter writer(os);
+                writer.begin_object();
+                writer.key("name"); writer.value(arg->name());
+                writer.key("value");
+                if (arg->nargs() == '+' || arg->nargs() == '*' || arg->nargs() == 'N') {
+                    writer.value(values);
+                } else {
+                    writer.value(values[0]);
+                }
+                writer.key("provenance"); writer.value(provenance_name(arg->dest_provenance()));
+                writer.key("group"); writer.value(arg->group_name());
+                writer.end_object();
+            } else {
+                assert(format == ValueDumpFormat::CSV);
+                write_csv_field(os, arg->name());
+                os << ',';
+                write_csv_field(os, join(values, " "));
+                os << ',' << provenance_name(arg->dest_provenance()) << ',';
+                write_csv_field(os, arg->group_name());
+            }
+            os << '\n';
+        }
+    }
+
+    void ArgumentParser::dump_values(std::string& buf, ValueDumpFormat format) {
+        StringAppendStreambuf streambuf(buf);
+        std::ostream os(&streambuf);
+        dump_values(os, format);
+    }
+
+    //Writes str as a CSV field, quoting it if required
+    void write_csv_field(std::ostream& os, const std::string& str) {
+        if (str.find_first_of(",\"\n\r") == std::string::npos) {
+            os << str;
+            return;
+        }
+
+        os << '"';
+        for (char c : str) {
+            if (c == '"') {
+                os << '"'; //Escaped by doubling
+            }
+            os << c;
+        }
+        os << '"';
+    }
+
+} //namespace
@@ -1,4 +1,13 @@
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+
+#ifndef _WIN32
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
+
 #include "argparse_formatter.hpp"
 #include "argparse_util.hpp"
 
@@ -6,12 +15,153 @@
 
 namespace argparse {
     constexpr size_t OPTION_HELP_SLACK = 2;
-    std::string INDENT = "  ";
-    std::string USAGE_PREFIX = "usage: ";
+    //Constant-initialized, so they cost nothing at start-up
+    constexpr StrRef INDENT = "  ";
+    constexpr StrRef USAGE_PREFIX = "usage: ";
+    constexpr StrRef WORD_BREAKS[] = {" ", "/"};
+    constexpr StrRef USAGE_BREAKS[] = {" [", " -"};
+
+    size_t write_long_option(FormatSink& sink, const Argument& argument);
+    size_t write_short_option(FormatSink& sink, const Argument& argument);
+    size_t write_metavar(FormatSink& sink, const Argument& argument);
+    size_t write_base_metavar(FormatSink& sink, const Argument& argument);
+    void write_wrapped(FormatSink& sink, const std::string& str, size_t width);
+
+    /*
+     * FormatSink
+     */
+    void FormatSink::write(const char* str) {
+        append(str, std::strlen(str));
+    }
+
+    void FormatSink::write_repeated(char c, size_t count) {
+        char chars[64];
+        std::memset(chars, c, sizeof(chars));
+        while (count > 0) {
+            size_t chunk = std::min(count, sizeof(chars));
+            append(chars, chunk);
+            count -= chunk;
+        }
+    }
+
+    void StringSink::append(const char* data, size_t size) {
+        buf_.append(data, size);
+    }
+
+    void OstreamSink::append(const char* data, size_t size) {
+        os_.write(data, size);
+    }
+
+    void OstreamSink::flush() {
+        os_.flush();
+    }
+
+#ifndef _WIN32
+    constexpr size_t FdSink::BUFFER_SIZE;
+
+    FdSink::~FdSink() {
+        try {
+            flush();
+        } catch (const ArgParseError&) {
+            //Nowhere to report the failure
+        }
+    }
+
+    void FdSink::flush() {
+        write_out(nullptr, 0);
+    }
+
+    void FdSink::append(const char* data, size_t size) {
+        if (size <= BUFFER_SIZE - buffer_size_) {
+            std::memcpy(buffer_ + buffer_size_, data, size);
+            buffer_size_ += size;
+        } else {
+            write_out(data, size);
+        }
+    }
+
+    void FdSink::write_out(const char* data, size_t size) {
+        iovec iov[2];
+        iov[0].iov_base = buffer_;
+        iov[0].iov_len = buffer_size_;
+        iov[1].iov_base = const_cast<char*>(data);
+        iov[1].iov_len = size;
+        buffer_size_ = 0;
+
+        iovec* remaining = iov;
+        int num_remaining = 2;
+        while (num_remaining > 0) {
+            if (remaining->iov_len == 0) {
+                ++remaining;
+                --num_remaining;
+                continue;
+            }
+
+            ssize_t num_written = ::writev(fd_, remaining, num_remaining);
+            if (num_written < 0) {
+                if (errno == EINTR) continue;
+                throw ArgParseError(std::string("Failed to write output (") + std::strerror(errno) + ")");
+            }
+
+            //Skip past what was written, which may end part way through a buffer
+            size_t num_bytes = num_written;
+            while (num_remaining > 0 && num_bytes >= remaining->iov_len) {
+                num_bytes -= remaining->iov_len;
+                ++remaining;
+                --num_remaining;
+            }
+            if (num_remaining > 0) {
+                remaining->iov_base = static_cast<char*>(remaining->iov_base) + num_bytes;
+                remaining->iov_len -= num_bytes;
+            }
+        }
+    }
+#endif
+
+    /*
+     * Formatter
+     */
+    std::string Formatter::format_usage() const {
+        std::string str;
+        StringSink sink(str);
+        write_usage(sink);
+        return str;
+    }
+
+    std::string Formatter::format_description() const {
+        std::string str;
+        StringSink sink(str);
+        write_description(sink);
+        return str;
+    }
+
+    std::string Formatter::format_arguments() const {
+        std::string str;
+        StringSink sink(str);
+        write_arguments(sink);
+        return str;
+    }
+
+    std::string Formatter::format_epilog() const {
+        std::string str;
+        StringSink sink(str);
+        write_epilog(sink);
+        return str;
+    }
+
+    std::string Formatter::format_version() const {
+        std::string str;
+        StringSink sink(str);
+        write_version(sink);
+        return str;
+    }
+
+    void Formatter::write_usage(FormatSink& sink) const { sink.write(format_usage()); }
+    void Formatter::write_description(FormatSink& sink) const { sink.write(format_description()); }
+    void Formatter::write_arguments(FormatSink& sink) const { sink.write(format_arguments()); }
+    void Formatter::write_epilog(FormatSink& sink) const { sink.write(format_epilog()); }
+    void Formatter::write_version(FormatSink& sink) const { sink.write(format_version()); }
 
-    std::string long_option_str(const Argument& argument);
-    std::string short_option_str(const Argument& argument);
-    std::string determine_metavar(const Argument& argument);
     /*
      * DefaultFormatter
      */
@@ -24,225 +174,310 @@ namespace argparse {
         parser_ = parser;
     }
 
-    std::string DefaultFormatter::format_usage() const {
+    void DefaultFormatter::write_usage(FormatSink& sink) const {
         if (!parser_) throw ArgParseError("parser not initialized in help formatter");
 
-
-        std::stringstream ss;
-        ss << USAGE_PREFIX << parser_->prog();
+        //The usage is wrapped as a whole, so is assembled first
+        usage_buf_.clear();
+        StringSink usage(usage_buf_);
+        usage.write(USAGE_PREFIX.data, USAGE_PREFIX.size);
+        usage.write(parser_->prog());
 
         int num_unshown_options = 0;
-        for (const auto& group : parser_->argument_groups()) {
-            auto args = group.arguments();
-            for(const auto& arg : args) {
+        for (const auto& group : parser_->argument_groups_view()) {
+            for(const auto& arg : group.arguments()) {
 
                 if(arg->show_in() != ShowIn::USAGE_AND_HELP) {
                     num_unshown_options++;
                     continue;
                 }
 
-                ss << " ";
+                usage.write(' ');
 
                 if (!arg->required()) {
-                    ss << "[";
+                    usage.write('[');
                 }
 
-                auto short_opt = short_option_str(*arg);
-                if (!short_opt.empty()) {
-                    ss << short_opt; 
+                if (!arg->short_option().empty()) {
+                    write_short_option(usage, *arg);
                 } else {
-                    ss << long_option_str(*arg);
+                    write_long_option(usage, *arg);
                 }
 
                 if (!arg->required()) {
-                    ss << "]";
+                    usage.write(']');
                 }
             }
         }
         if (num_unshown_options > 0) {
-            ss << " [OTHER_OPTIONS ...]";
+            usage.write(" [OTHER_OPTIONS ...]");
         }
 
-        size_t prefix_len = USAGE_PREFIX.size();
+        auto subparsers = parser_->subparsers();
+        if (subparsers) {
+            usage.write(' ');
+            if (!subparsers->required()) {
+                usage.write('[');
+            }
+            usage.write('{');
+            bool first = true;
+            for (const auto& name : subparsers->names()) {
+                if (!first) {
+                    usage.write(", ");
+                }
+                usage.write(name);
+                first = false;
+            }
+            usage.write("} ...");
+            if (!subparsers->required()) {
+                usage.write(']');
+            }
+        }
+
+        size_t prefix_len = USAGE_PREFIX.size;
 
-        std::stringstream wrapped_ss;
         bool first = true;
-        for(const auto& line : wrap_width(ss.str(), total_width_ - prefix_len, {" [", " -"})) {
+        visit_wrapped_lines(usage_buf_, total_width_ - prefix_len, USAGE_BREAKS, [&](StrRef line, bool wrapped) {
             if(!first) {
-                //pass
-                wrapped_ss << std::string(prefix_len, ' ');
+                sink.write_repeated(' ', prefix_len);
+            }
+            sink.write(line.data, line.size);
+            if (wrapped) {
+                sink.write('\n');
             }
-            wrapped_ss << line;
             first = false;
-        }
-        wrapped_ss << "\n";
-
-        return wrapped_ss.str();
+        });
+        sink.write('\n');
     }
 
-    std::string DefaultFormatter::format_description() const {
+    void DefaultFormatter::write_description(FormatSink& sink) const {
         if (!parser_) throw ArgParseError("parser not initialized in help formatter");
 
-        std::stringstream ss;
-        ss << "\n";
-        for(auto& line : wrap_width(parser_->description(), total_width_, {" ", "/"})) {
-            ss << line;
-        }
-        ss << "\n";
-        return ss.str();
+        sink.write('\n');
+        write_wrapped(sink, parser_->description(), total_width_);
+        sink.write('\n');
     }
 
-    std::string DefaultFormatter::format_arguments() const {
+    void DefaultFormatter::write_arguments(FormatSink& sink) const {
         if (!parser_) throw ArgParseError("parser not initialized in help formatter");
 
-        std::stringstream ss;
-
-        for (const auto& group : parser_->argument_groups()) {
-            auto args = group.arguments();
+        for (const auto& group : parser_->argument_groups_view()) {
+            const auto& args = group.arguments();
             if (args.size() > 0) {
-                ss << "\n";
-                ss << group.name() << ":" << "\n";
+                sink.write('\n');
+                sink.write(group.name());
+                sink.write(":\n");
                 for (const auto& arg : args) {
-                    std::stringstream arg_ss;
-                    arg_ss << std::boolalpha;
-
-
-                    auto long_opt_descr = long_option_str(*arg);
-                    auto short_opt_descr = short_option_str(*arg);
-
                     //name/option
-                    arg_ss << INDENT;
-                    if (!short_opt_descr.empty()) {
-                        arg_ss << short_opt_descr;
+                    sink.write(INDENT.data, INDENT.size);
+                    size_t pos = INDENT.size;
+
+                    bool has_short_opt = !arg->short_option().empty();
+                    if (has_short_opt) {
+                        pos += write_short_option(sink, *arg);
                     }
-                    if (!long_opt_descr.empty()) {
-                        if (!short_opt_descr.empty()) {
-                            arg_ss << ", ";
+                    if (!arg->long_option().empty() || (arg->nargs() != '0' && !arg->positional())) {
+                        if (has_short_opt) {
+                            sink.write(", ");
+                            pos += 2;
                         }
-                        arg_ss << long_opt_descr;
+                        pos += write_long_option(sink, *arg);
                     }
 
-                    size_t pos = arg_ss.str().size();
-
                     if (pos + OPTION_HELP_SLACK > option_name_width_) {
                         //If the option name is too long, wrap the help 
                         //around to a new line
-                        arg_ss << "\n";
+                        sink.write('\n');
                         pos = 0;
                     }
                     
                     //Argument help
-                    auto help_lines = wrap_width(arg->help(), total_width_ - option_name_width_, {" ", "/"});
-                    for (auto& line : help_lines) {
+                    visit_wrapped_lines(arg->help(), total_width_ - option_name_width_, WORD_BREAKS, [&](StrRef line, bool wrapped) {
                         //Pad out the help
                         assert(pos <= option_name_width_);
-                        arg_ss << std::string(option_name_width_ - pos, ' ');
+                        sink.write_repeated(' ', option_name_width_ - pos);
 
                         //Print a wrapped line
-                        arg_ss << line;
+                        sink.write(line.data, line.size);
+                        if (wrapped) {
+                            sink.write('\n');
+                        }
                         pos = 0;
-                    }
+                    });
 
                     //Default
-                    if (!arg->default_value().empty()) {
-                        if(!arg->help().empty()) {
-                            arg_ss << " ";
+                    if (arg->default_set()) {
+                        auto default_str = arg->default_value();
+                        if (!default_str.empty()) {
+                            if(!arg->help().empty()) {
+                                sink.write(' ');
+                            }
+                            sink.write("(Default: ");
+                            sink.write(default_str);
+                            sink.write(')');
                         }
-                        arg_ss << "(Default: " << arg->default_value() << ")";
                     }
-                    arg_ss << "\n";
-                    ss << arg_ss.str();
+                    sink.write('\n');
                 }
                 if (!group.epilog().empty()) {
-                    ss << "\n";
+                    sink.write('\n');
 
-                    auto epilog_lines = wrap_width(group.epilog(), total_width_ - INDENT.size(), {" ", "/"});
-                    for (auto& line : epilog_lines) {
-                        ss << INDENT << line;
-                    }
-                    ss << "\n";
+                    visit_wrapped_lines(group.epilog(), total_width_ - INDENT.size, WORD_BREAKS, [&](StrRef line, bool wrapped) {
+                        sink.write(INDENT.data, INDENT.size);
+                        sink.write(line.data, line.size);
+                        if (wrapped) {
+                            sink.write('\n');
+                        }
+                    });
+                    sink.write('\n');
                 }
             }
         }
 
-        return ss.str();
+
+        auto subparsers = parser_->subparsers();
+        if (subparsers) {
+            sink.write('\n');
+            sink.write(subparsers->title());
+            sink.write(":\n");
+            for (const auto& name : subparsers->names()) {
+                sink.write(INDENT.data, INDENT.size);
+                sink.write(name);
+
+                size_t pos = INDENT.size + name.size();
+                if (pos + OPTION_HELP_SLACK > option_name_width_) {
+                    sink.write('\n');
+                    pos = 0;
+                }
+
+                visit_wrapped_lines(subparsers->help(name), total_width_ - option_name_width_, WORD_BREAKS, [&](StrRef line, bool wrapped) {
+                    sink.write_repeated(' ', option_name_width_ - pos);
+                    sink.write(line.data, line.size);
+                    if (wrapped) {
+                        sink.write('\n');
+                    }
+                    pos = 0;
+                });
+                sink.write('\n');
+            }
+        }
     }
 
-    std::string DefaultFormatter::format_epilog() const {
+    void DefaultFormatter::write_epilog(FormatSink& sink) const {
         if (!parser_) throw ArgParseError("parser not initialized in help formatter");
 
-        std::stringstream ss;
-        ss << "\n";
-        for(auto& line : wrap_width(parser_->epilog(), total_width_, {" ", "/"})) {
-            ss << line;
-        }
-        ss << "\n";
-        return ss.str();
+        sink.write('\n');
+        write_wrapped(sink, parser_->epilog(), total_width_);
+        sink.write('\n');
     }
 
-    std::string DefaultFormatter::format_version() const {
+    void DefaultFormatter::write_version(FormatSink& sink) const {
         if (!parser_) throw ArgParseError("parser not initialized in help formatter");
-        return parser_->version() + "\n";
+        sink.write(parser_->version());
+        sink.write('\n');
     }
 
     /*
      * Utilities
      */
-    std::string long_option_str(const Argument& argument) {
-        auto long_opt = argument.long_option();
+    //Writes the long option (followed by its metavar, if any), returning the number of characters written
+    size_t write_long_option(FormatSink& sink, const Argument& argument) {
+        size_t size = argument.long_option().size();
+        sink.write(argument.long_option());
         if(argument.nargs() != '0' && !argument.positional()) {
-            long_opt += + " " + determine_metavar(argument);
+            sink.write(' ');
+            size += 1 + write_metavar(sink, argument);
         }
-        return long_opt;
+        return size;
     }
 
-    std::string short_option_str(const Argument& argument) {
-        auto short_opt = argument.short_option();
-        if(!short_opt.empty()) {
-            if(argument.nargs() != '0' && !argument.positional()) {
-                short_opt += " " + determine_metavar(argument);
-            }
-            return short_opt;
-        } else {
-            return "";
+    //Writes the short option (followed by its metavar, if any), returning the number of characters written
+    size_t write_short_option(FormatSink& sink, const Argument& argument) {
+        const auto& short_opt = argument.short_option();
+        if(short_opt.empty()) {
+            return 0;
         }
-    }
 
-    std::string determine_metavar(const Argument& arg) {
-
-        std::string base_metavar = arg.metavar();
-        if (!arg.choices().empty()) {
-            //We allow choices to override the default metavar
-            std::stringstream choices_ss;
-            choices_ss << "{";
-            bool first = true;
-            for(auto choice : arg.choices()) {
-                if (!first) {
-                    choices_ss << ", ";
-                }
-                choices_ss << choice;
-                first = false;
-            }
-            choices_ss << "}";
-            base_metavar = choices_ss.str();
+        size_t size = short_opt.size();
+        sink.write(short_opt);
+        if(argument.nargs() != '0' && !argument.positional()) {
+            sink.write(' ');
+            size += 1 + write_metavar(sink, argument);
         }
+        return size;
+    }
 
-        std::string metavar;
+    //Writes the metavar decorated to reflect the argument's nargs, returning the number of characters written
+    size_t write_metavar(FormatSink& sink, const Argument& arg) {
+        size_t size = 0;
         if (arg.nargs() == '0' || arg.positional()) {
             //empty
-            metavar = "";
         } else if (arg.nargs() == '1') {
-            metavar = base_metavar;
+            size += write_base_metavar(sink, arg);
         } else if (arg.nargs() == '?') {
-            metavar = "[" + base_metavar + "]";
+            sink.write('[');
+            size += write_base_metavar(sink, arg);
+            sink.write(']');
+            size += 2;
         } else if (arg.nargs() == '+') {
-            metavar = base_metavar + " [" + base_metavar + " ...]";
+            size += write_base_metavar(sink, arg);
+            sink.write(" [");
+            size += write_base_metavar(sink, arg);
+            sink.write(" ...]");
+            size += 7;
         } else if (arg.nargs() == '*') {
-            metavar = "[" + base_metavar + " [" + base_metavar + " ...]]";
+            sink.write('[');
+            size += write_base_metavar(sink, arg);
+            sink.write(" [");
+            size += write_base_metavar(sink, arg);
+            sink.write(" ...]]");
+            size += 9;
+        } else if (arg.nargs() == 'N') {
+            for (size_t ivalue = 0; ivalue < arg.num_values(); ++ivalue) {
+                if (ivalue > 0) {
+                    sink.write(' ');
+                    size += 1;
+                }
+                size += write_base_metavar(sink, arg);
+            }
         } else {
             assert(false);
         }
-        return metavar;
+        return size;
+    }
+
+    //Writes the argument's metavar, or its choices (which override the metavar), returning the number of characters written
+    size_t write_base_metavar(FormatSink& sink, const Argument& arg) {
+        const auto& choices = arg.choices();
+        if (choices.empty()) {
+            sink.write(arg.metavar());
+            return arg.metavar().size();
+        }
+
+        size_t size = 2;
+        sink.write('{');
+        bool first = true;
+        for(const auto& choice : choices) {
+            if (!first) {
+                sink.write(", ");
+                size += 2;
+            }
+            sink.write(choice);
+            size += choice.size();
+            first = false;
+        }
+        sink.write('}');
+        return size;
+    }
+
+    //Writes str wrapped to width
+    void write_wrapped(FormatSink& sink, const std::string& str, size_t width) {
+        visit_wrapped_lines(str, width, WORD_BREAKS, [&](StrRef line, bool wrapped) {
+            sink.write(line.data, line.size);
+            if (wrapped) {
+                sink.write('\n');
+            }
+        });
     }
 
 } //namespace
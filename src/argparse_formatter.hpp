@@ -1,35 +1,129 @@
 #ifndef ARGPARSE_FORMATTER_HPP
 #define ARGPARSE_FORMATTER_HPP
+#include <iosfwd>
 #include <string>
 
 namespace argparse {
 
     class ArgumentParser;
 
+    /*
+     * FormatSink receives formatted output as it is produced
+     *
+     * Formatters write into a sink piece by piece, so help can be rendered into a
+     * re-used buffer (StringSink) or directly to its destination (OstreamSink, FdSink)
+     * without building intermediate strings.
+     */
+    class FormatSink {
+        public:
+            virtual ~FormatSink() {}
+
+            void write(const char* data, size_t size) { append(data, size); }
+            void write(const char* str);
+            void write(const std::string& str) { append(str.data(), str.size()); }
+            void write(char c) { append(&c, 1); }
+
+            //Writes count copies of c (e.g. padding)
+            void write_repeated(char c, size_t count);
+
+            //Delivers any buffered output to the destination
+            virtual void flush() {}
+        protected:
+            virtual void append(const char* data, size_t size) = 0;
+    };
+
+    //Appends to a string, which may be re-used (after clearing it) to avoid re-allocation
+    class StringSink : public FormatSink {
+        public:
+            explicit StringSink(std::string& buf) : buf_(buf) {}
+        protected:
+            void append(const char* data, size_t size) override;
+        private:
+            std::string& buf_;
+    };
+
+    //Writes to an output stream
+    class OstreamSink : public FormatSink {
+        public:
+            explicit OstreamSink(std::ostream& os) : os_(os) {}
+            void flush() override;
+        protected:
+            void append(const char* data, size_t size) override;
+        private:
+            std::ostream& os_;
+    };
+
+#ifndef _WIN32
+    /*
+     * FdSink writes to a (POSIX) file descriptor
+     *
+     * Small writes are gathered in a fixed buffer. Writes too large to fit are sent
+     * together with the buffered output in a single writev() call, so the output is
+     * never copied more than once and usually takes a handful of system calls.
+     * Throws ArgParseError if writing fails.
+     */
+    class FdSink : public FormatSink {
+        public:
+            explicit FdSink(int fd) : fd_(fd) {}
+            ~FdSink(); //Flushes, ignoring any error
+
+            FdSink(const FdSink&) = delete;
+            FdSink& operator=(const FdSink&) = delete;
+
+            void flush() override;
+        protected:
+            void append(const char* data, size_t size) override;
+        private:
+            //Writes the buffered output followed by [data, data + size)
+            void write_out(const char* data, size_t size);
+        private:
+            static constexpr size_t BUFFER_SIZE = 4096;
+
+            int fd_;
+            char buffer_[BUFFER_SIZE];
+            size_t buffer_size_ = 0;
+    };
+#endif
+
+    /*
+     * Formatter renders the parts of a parser's help
+     *
+     * Each part can be written into a FormatSink, or returned as a string. By default
+     * each is implemented in terms of the other, so implementations must override (at
+     * least) one of each pair. Overriding the write_*() methods avoids building strings.
+     */
     class Formatter {
         public:
             virtual ~Formatter() {}
             virtual void set_parser(ArgumentParser* parser) = 0;
-            virtual std::string format_usage() const = 0;
-            virtual std::string format_description() const = 0;
-            virtual std::string format_arguments() const = 0;
-            virtual std::string format_epilog() const = 0;
-            virtual std::string format_version() const = 0;
+
+            virtual std::string format_usage() const;
+            virtual std::string format_description() const;
+            virtual std::string format_arguments() const;
+            virtual std::string format_epilog() const;
+            virtual std::string format_version() const;
+
+            virtual void write_usage(FormatSink& sink) const;
+            virtual void write_description(FormatSink& sink) const;
+            virtual void write_arguments(FormatSink& sink) const;
+            virtual void write_epilog(FormatSink& sink) const;
+            virtual void write_version(FormatSink& sink) const;
     };
 
     class DefaultFormatter : public Formatter {
         public:
             DefaultFormatter(size_t option_arg_width=20, size_t total_width=80);
             void set_parser(ArgumentParser* parser) override;
-            std::string format_usage() const override;
-            std::string format_description() const override;
-            std::string format_arguments() const override;
-            std::string format_epilog() const override;
-            std::string format_version() const override;
+            void write_usage(FormatSink& sink) const override;
+            void write_description(FormatSink& sink) const override;
+            void write_arguments(FormatSink& sink) const override;
+            void write_epilog(FormatSink& sink) const override;
+            void write_version(FormatSink& sink) const override;
         private:
             size_t option_name_width_;
             size_t total_width_;
-            ArgumentParser* parser_;
+            ArgumentParser* parser_ = nullptr;
+            mutable std::string usage_buf_; //Re-used to assemble the usage before wrapping it
     };
 
 } //namespace
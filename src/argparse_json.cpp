@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstdio>
+
+#include "argparse_json.hpp"
+
+namespace argparse {
+
+    void JsonWriter::begin_object() {
+        begin_element();
+        os_ << '{';
+        first_element_.push_back(true);
+    }
+
+    void JsonWriter::end_object() {
+        assert(!first_element_.empty());
+        first_element_.pop_back();
+        os_ << '}';
+    }
+
+    void JsonWriter::begin_array() {
+        begin_element();
+        os_ << '[';
+        first_element_.push_back(true);
+    }
+
+    void JsonWriter::end_array() {
+        assert(!first_element_.empty());
+        first_element_.pop_back();
+        os_ << ']';
+    }
+
+    void JsonWriter::key(const std::string& name) {
+        begin_element();
+        write_string(name);
+        os_ << ':';
+        after_key_ = true;
+    }
+
+    void JsonWriter::value(const std::string& str) {
+        begin_element();
+        write_string(str);
+    }
+
+    void JsonWriter::value(const char* str) {
+        value(std::string(str));
+    }
+
+    void JsonWriter::value(bool b) {
+        begin_element();
+        os_ << (b ? "true" : "false");
+    }
+
+    void JsonWriter::value(int64_t num) {
+        begin_element();
+        os_ << num;
+    }
+
+    void JsonWriter::value(const std::vector<std::string>& strs) {
+        begin_array();
+        for (const auto& str : strs) {
+            value(str);
+        }
+        end_array();
+    }
+
+    void JsonWriter::null() {
+        begin_element();
+        os_ << "null";
+    }
+
+    void JsonWriter::begin_element() {
+        if (after_key_) {
+            //Value of a key, which was already separated
+            after_key_ = false;
+            return;
+        }
+        if (!first_element_.empty()) {
+            if (!first_element_.back()) {
+                os_ << ',';
+            }
+            first_element_.back() = false;
+        }
+    }
+
+    void JsonWriter::write_string(const std::string& str) {
+        os_ << '"';
+        for (char c : str) {
+            switch (c) {
+                case '"': os_ << "\\\""; break;
+                case '\\': os_ << "\\\\"; break;
+                case '\n': os_ << "\\n"; break;
+                case '\r': os_ << "\\r"; break;
+                case '\t': os_ << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[7];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                        os_ << buf;
+                    } else {
+                        os_ << c;
+                    }
+            }
+        }
+        os_ << '"';
+    }
+
+} //namespace
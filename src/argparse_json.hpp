@@ -0,0 +1,53 @@
+#ifndef ARGPARSE_JSON_HPP
+#define ARGPARSE_JSON_HPP
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace argparse {
+
+    /*
+     * JsonWriter streams (compact) JSON directly to an ostream
+     *
+     * Values are written as they are produced, without building a document
+     * in memory. Commas between elements are inserted automatically, so callers
+     * only describe the structure:
+     *
+     *      writer.begin_object();
+     *      writer.key("name"); writer.value("--seed");
+     *      writer.key("choices"); writer.value(std::vector<std::string>{"a", "b"});
+     *      writer.end_object();
+     */
+    class JsonWriter {
+        public:
+            JsonWriter(std::ostream& os) : os_(os) {}
+
+            void begin_object();
+            void end_object();
+
+            void begin_array();
+            void end_array();
+
+            //Writes the key of the next member of the current object
+            void key(const std::string& name);
+
+            void value(const std::string& str);
+            void value(const char* str);
+            void value(bool b);
+            void value(int64_t num);
+            void value(const std::vector<std::string>& strs);
+            void null();
+        private:
+            //Writes the comma preceeding any non-first element
+            void begin_element();
+
+            void write_string(const std::string& str);
+        private:
+            std::ostream& os_;
+            std::vector<bool> first_element_; //Whether the next element is the first of each open object/array
+            bool after_key_ = false;
+    };
+
+} //namespace
+#endif
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "argparse_memory.hpp"
+
+namespace argparse {
+
+    /*
+     * new_delete_resource()
+     */
+    namespace {
+        class NewDeleteResource : public MemoryResource {
+            protected:
+                void* do_allocate(size_t bytes, size_t alignment) override {
+                    if (alignment > alignof(std::max_align_t)) {
+                        //Over-aligned allocation is not supported by operator new before C++17
+                        throw std::bad_alloc();
+                    }
+                    return ::operator new(bytes);
+                }
+
+                void do_deallocate(void* ptr, size_t /*bytes*/, size_t /*alignment*/) override {
+                    ::operator delete(ptr);
+                }
+
+                bool do_is_equal(const MemoryResource& other) const noexcept override {
+                    //All instances share the global heap
+                    return dynamic_cast<const NewDeleteResource*>(&other) != nullptr;
+                }
+        };
+    }
+
+    MemoryResource* new_delete_resource() {
+        static NewDeleteResource resource;
+        return &resource;
+    }
+
+    /*
+     * MonotonicBufferResource
+     */
+    constexpr size_t MonotonicBufferResource::MIN_CHUNK_SIZE;
+
+    MonotonicBufferResource::MonotonicBufferResource(MemoryResource* upstream)
+        : upstream_(upstream)
+        {}
+
+    MonotonicBufferResource::MonotonicBufferResource(void* buffer, size_t buffer_size, MemoryResource* upstream)
+        : upstream_(upstream)
+        , initial_buffer_(buffer)
+        , initial_buffer_size_(buffer_size)
+        , current_(static_cast<char*>(buffer))
+        , space_(buffer_size)
+        {}
+
+    MonotonicBufferResource::~MonotonicBufferResource() {
+        release();
+    }
+
+    void MonotonicBufferResource::release() {
+        while (chunks_) {
+            Chunk* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->size);
+            chunks_ = next;
+        }
+        current_ = static_cast<char*>(initial_buffer_);
+        space_ = initial_buffer_size_;
+        next_chunk_size_ = MIN_CHUNK_SIZE;
+    }
+
+    void* MonotonicBufferResource::do_allocate(size_t bytes, size_t alignment) {
+        void* ptr = current_;
+        if (!ptr || !std::align(alignment, bytes, ptr, space_)) {
+            //Start a new chunk, large enough for the request even after aligning it
+            size_t chunk_size = std::max(next_chunk_size_, sizeof(Chunk) + bytes + alignment);
+            Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(chunk_size));
+            chunk->next = chunks_;
+            chunk->size = chunk_size;
+            chunks_ = chunk;
+            next_chunk_size_ = chunk_size * 2;
+
+            ptr = reinterpret_cast<char*>(chunk) + sizeof(Chunk);
+            space_ = chunk_size - sizeof(Chunk);
+            std::align(alignment, bytes, ptr, space_);
+        }
+
+        current_ = static_cast<char*>(ptr) + bytes;
+        space_ -= bytes;
+        return ptr;
+    }
+
+    void MonotonicBufferResource::do_deallocate(void* /*ptr*/, size_t /*bytes*/, size_t /*alignment*/) {
+        //Memory is only reclaimed by release()
+    }
+
+    /*
+     * UnsynchronizedPoolResource
+     */
+    constexpr size_t UnsynchronizedPoolResource::MAX_POOLED_SIZE;
+    constexpr size_t UnsynchronizedPoolResource::MIN_BLOCK_SIZE;
+    constexpr size_t UnsynchronizedPoolResource::NUM_POOLS;
+    constexpr size_t UnsynchronizedPoolResource::BLOCKS_PER_CHUNK;
+
+    UnsynchronizedPoolResource::UnsynchronizedPoolResource(MemoryResource* upstream)
+        : upstream_(upstream)
+        , chunks_(upstream)
+        {}
+
+    UnsynchronizedPoolResource::~UnsynchronizedPoolResource() {
+        release();
+    }
+
+    void UnsynchronizedPoolResource::release() {
+        std::fill(std::begin(free_lists_), std::end(free_lists_), nullptr);
+        chunks_.release();
+    }
+
+    size_t UnsynchronizedPoolResource::pool_index(size_t bytes, size_t alignment) {
+        if (alignment > alignof(std::max_align_t)) {
+            //Pooled blocks are at most max_align_t aligned
+            return NUM_POOLS;
+        }
+        size_t size = std::max(std::max(bytes, alignment), MIN_BLOCK_SIZE);
+        size_t block_size = MIN_BLOCK_SIZE;
+        size_t idx = 0;
+        while (block_size < size) {
+            block_size *= 2;
+            ++idx;
+        }
+        return (block_size <= MAX_POOLED_SIZE) ? idx : NUM_POOLS;
+    }
+
+    void* UnsynchronizedPoolResource::do_allocate(size_t bytes, size_t alignment) {
+        size_t idx = pool_index(bytes, alignment);
+        if (idx == NUM_POOLS) {
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        if (!free_lists_[idx]) {
+            //Carve a new batch of blocks, which are aligned to their (power-of-two) size
+            size_t block_size = MIN_BLOCK_SIZE << idx;
+            size_t block_alignment = std::min(block_size, alignof(std::max_align_t));
+            char* blocks = static_cast<char*>(chunks_.allocate(block_size * BLOCKS_PER_CHUNK, block_alignment));
+            for (size_t i = 0; i < BLOCKS_PER_CHUNK; ++i) {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + i * block_size);
+                block->next = free_lists_[idx];
+                free_lists_[idx] = block;
+            }
+        }
+
+        FreeBlock* block = free_lists_[idx];
+        free_lists_[idx] = block->next;
+        return block;
+    }
+
+    void UnsynchronizedPoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+        size_t idx = pool_index(bytes, alignment);
+        if (idx == NUM_POOLS) {
+            upstream_->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_lists_[idx];
+        free_lists_[idx] = block;
+    }
+
+} //namespace
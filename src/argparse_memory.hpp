@@ -0,0 +1,196 @@
+#ifndef ARGPARSE_MEMORY_HPP
+#define ARGPARSE_MEMORY_HPP
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace argparse {
+
+    /*
+     * MemoryResource is the source of memory for a parser's internal storage
+     *
+     * It follows the interface of C++17's std::pmr::memory_resource, so the
+     * parser can be backed by (for instance) a buffer on the stack for one-shot
+     * parsing, or a per-thread pool in a service which repeatedly re-parses.
+     */
+    class MemoryResource {
+        public:
+            virtual ~MemoryResource() = default;
+
+            void* allocate(size_t bytes, size_t alignment=alignof(std::max_align_t)) {
+                return do_allocate(bytes, alignment);
+            }
+
+            void deallocate(void* ptr, size_t bytes, size_t alignment=alignof(std::max_align_t)) {
+                do_deallocate(ptr, bytes, alignment);
+            }
+
+            //Returns true if memory allocated by this resource can be deallocated by other (and vice versa)
+            bool is_equal(const MemoryResource& other) const noexcept {
+                return do_is_equal(other);
+            }
+        protected:
+            virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+            virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+            virtual bool do_is_equal(const MemoryResource& other) const noexcept { return this == &other; }
+    };
+
+    inline bool operator==(const MemoryResource& lhs, const MemoryResource& rhs) {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+    inline bool operator!=(const MemoryResource& lhs, const MemoryResource& rhs) {
+        return !(lhs == rhs);
+    }
+
+    //Returns a resource which allocates with the global operator new (the default)
+    MemoryResource* new_delete_resource();
+
+    /*
+     * MonotonicBufferResource hands out memory from an (optional) initial buffer,
+     * and then from progressively larger chunks obtained from its upstream resource.
+     *
+     * Deallocation is a no-op: memory is only reclaimed by release() or destruction,
+     * making allocation very cheap but usage unbounded if the parser is used repeatedly.
+     */
+    class MonotonicBufferResource : public MemoryResource {
+        public:
+            explicit MonotonicBufferResource(MemoryResource* upstream=new_delete_resource());
+            MonotonicBufferResource(void* buffer, size_t buffer_size, MemoryResource* upstream=new_delete_resource());
+            ~MonotonicBufferResource();
+
+            MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+            MonotonicBufferResource& operator=(const MonotonicBufferResource&) = delete;
+
+            //Returns all chunks to the upstream resource, and restarts from the initial buffer
+            // Must not be called while any memory allocated from this resource is in use
+            void release();
+
+            MemoryResource* upstream_resource() const { return upstream_; }
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        private:
+            static constexpr size_t MIN_CHUNK_SIZE = 1024;
+
+            struct Chunk {
+                Chunk* next;
+                size_t size; //Total size (including this header)
+            };
+        private:
+            MemoryResource* upstream_;
+            void* initial_buffer_ = nullptr;
+            size_t initial_buffer_size_ = 0;
+            Chunk* chunks_ = nullptr; //Most recently allocated chunk first
+            char* current_ = nullptr; //Next free byte
+            size_t space_ = 0; //Free bytes after current_
+            size_t next_chunk_size_ = MIN_CHUNK_SIZE;
+    };
+
+    /*
+     * UnsynchronizedPoolResource keeps freed blocks in per-size free lists for re-use,
+     * so repeatedly parsing reaches a steady state with no upstream allocation.
+     *
+     * Requests are rounded up to a power-of-two size class; those larger than
+     * MAX_POOLED_SIZE go straight to the upstream resource. It is not thread-safe,
+     * and so is suited to a per-thread (or per-parser) pool.
+     */
+    class UnsynchronizedPoolResource : public MemoryResource {
+        public:
+            static constexpr size_t MAX_POOLED_SIZE = 1024;
+
+            explicit UnsynchronizedPoolResource(MemoryResource* upstream=new_delete_resource());
+            ~UnsynchronizedPoolResource();
+
+            UnsynchronizedPoolResource(const UnsynchronizedPoolResource&) = delete;
+            UnsynchronizedPoolResource& operator=(const UnsynchronizedPoolResource&) = delete;
+
+            //Returns all pooled memory to the upstream resource
+            // Must not be called while any memory allocated from this resource is in use
+            void release();
+
+            MemoryResource* upstream_resource() const { return upstream_; }
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+        private:
+            static constexpr size_t MIN_BLOCK_SIZE = 16;
+            static constexpr size_t NUM_POOLS = 7; //Size classes MIN_BLOCK_SIZE (16) through MAX_POOLED_SIZE
+            static constexpr size_t BLOCKS_PER_CHUNK = 32;
+            static_assert(MIN_BLOCK_SIZE << (NUM_POOLS - 1) == MAX_POOLED_SIZE, "Size classes must end at MAX_POOLED_SIZE");
+
+            struct FreeBlock {
+                FreeBlock* next;
+            };
+
+            //Returns the index of the pool serving allocations of bytes, or NUM_POOLS if they are not pooled
+            static size_t pool_index(size_t bytes, size_t alignment);
+        private:
+            MemoryResource* upstream_;
+            FreeBlock* free_lists_[NUM_POOLS] = {};
+            MonotonicBufferResource chunks_; //Memory carved into pooled blocks
+    };
+
+    /*
+     * PolymorphicAllocator adapts a MemoryResource to the standard allocator interface
+     * (as std::pmr::polymorphic_allocator), so standard containers can use it.
+     *
+     * Like std::pmr, copying a container does not propagate the resource: the copy
+     * uses new_delete_resource(). This keeps copies handed out through the public
+     * interface independent of the parser's (possibly shorter lived) resource.
+     */
+    template<typename T>
+    class PolymorphicAllocator {
+        public:
+            typedef T value_type;
+
+            PolymorphicAllocator() noexcept : resource_(new_delete_resource()) {}
+            PolymorphicAllocator(MemoryResource* resource) noexcept : resource_(resource) {}
+
+            template<typename U>
+            PolymorphicAllocator(const PolymorphicAllocator<U>& other) noexcept : resource_(other.resource()) {}
+
+            T* allocate(size_t n) {
+                return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T* ptr, size_t n) {
+                resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+            }
+
+            PolymorphicAllocator select_on_container_copy_construction() const {
+                return PolymorphicAllocator();
+            }
+
+            MemoryResource* resource() const noexcept { return resource_; }
+        private:
+            MemoryResource* resource_;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs) noexcept {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const PolymorphicAllocator<T>& lhs, const PolymorphicAllocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    //Standard containers allocating from a MemoryResource
+    template<typename T>
+    using PmrVector = std::vector<T,PolymorphicAllocator<T>>;
+
+    template<typename T>
+    using PmrList = std::list<T,PolymorphicAllocator<T>>;
+
+    template<typename T, typename Compare=std::less<T>>
+    using PmrSet = std::set<T,Compare,PolymorphicAllocator<T>>;
+
+    template<typename K, typename V, typename Hash=std::hash<K>, typename Equal=std::equal_to<K>>
+    using PmrUnorderedMap = std::unordered_map<K,V,Hash,Equal,PolymorphicAllocator<std::pair<const K,V>>>;
+
+} //namespace
+#endif
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <sstream>
+
+#include "argparse_option_index.hpp"
+#include "argparse.hpp"
+
+namespace argparse {
+
+    /*
+     * OptionIndex
+     */
+    OptionIndex::OptionIndex(MemoryResource* resource)
+        : option_strs_(resource)
+        , option_args_(resource)
+        , str_to_option_arg_(resource)
+        , option_trie_(resource)
+        {}
+
+    void OptionIndex::build(const PmrVector<std::shared_ptr<Argument>>& arguments) {
+        str_to_option_arg_.clear();
+        option_strs_.clear();
+        option_args_.clear();
+        short_options_.fill(nullptr);
+
+        for (const auto& arg : arguments) {
+            if (arg->positional()) continue;
+
+            for (const auto& opt : {arg->long_option(), arg->short_option()}) {
+                if (opt.empty()) continue;
+
+                option_strs_.push_back(opt);
+                option_args_.push_back(arg);
+            }
+        }
+
+        //The keys reference option_strs_, which must not be modified from here on
+        str_to_option_arg_.reserve(option_strs_.size());
+        for (size_t i = 0; i < option_strs_.size(); ++i) {
+            auto ret = str_to_option_arg_.insert(std::make_pair(StrRef(option_strs_[i]), option_args_[i]));
+
+            if (!ret.second) {
+                //Option string already specified
+                std::stringstream ss;
+                ss << "Option string '" << option_strs_[i] << "' maps to multiple options";
+                throw ArgParseError(ss.str());
+            }
+
+            const auto& opt = option_strs_[i];
+            if (opt.size() == 2 && opt[0] == '-' && opt[1] != '-') {
+                unsigned char idx = static_cast<unsigned char>(opt[1]);
+                if (idx < short_options_.size()) {
+                    short_options_[idx] = option_args_[i];
+                }
+            }
+        }
+
+        option_trie_.build(option_strs_);
+    }
+
+    std::shared_ptr<Argument> OptionIndex::find(StrRef opt) const {
+        auto iter = str_to_option_arg_.find(opt);
+        if (iter == str_to_option_arg_.end()) {
+            return nullptr;
+        }
+        return iter->second;
+    }
+
+    std::shared_ptr<Argument> OptionIndex::find_with_attached_value(const std::string& str, std::string& value) const {
+        size_t eq_pos = attached_value_pos(str);
+        if (eq_pos == std::string::npos) {
+            return nullptr;
+        }
+
+        auto arg = find(StrRef(str.data(), eq_pos));
+        if (arg) {
+            value.assign(str, eq_pos + 1, std::string::npos);
+        }
+        return arg;
+    }
+
+    std::shared_ptr<Argument> OptionIndex::find_abbreviation(StrRef prefix) const {
+        size_t first_key;
+        size_t num_matches = option_trie_.count_prefix_matches(prefix, first_key);
+        if (num_matches == 0) {
+            return nullptr;
+        } else if (num_matches == 1) {
+            return option_args_[first_key];
+        }
+
+        //Multiple option strings match, which is only unambiguous if they
+        //all belong to the same argument
+        auto keys = option_trie_.prefix_matches(prefix);
+        auto arg = option_args_[keys[0]];
+        std::vector<std::string> candidates;
+        for (size_t key : keys) {
+            candidates.push_back(option_strs_[key]);
+            if (option_args_[key] != arg) {
+                arg = nullptr;
+            }
+        }
+
+        if (!arg) {
+            std::stringstream msg;
+            msg << "Ambiguous option '" << std::string(prefix.data, prefix.size) << "' could match " << join(candidates, ", ");
+            throw ArgParseError(msg.str());
+        }
+        return arg;
+    }
+
+    std::vector<std::string> OptionIndex::options_with_prefix(StrRef prefix) const {
+        std::vector<std::string> options;
+        for (size_t key : option_trie_.prefix_matches(prefix)) {
+            options.push_back(option_strs_[key]);
+        }
+        return options;
+    }
+
+    std::vector<std::string> OptionIndex::suggest(const std::string& str) const {
+        constexpr size_t MAX_SUGGESTIONS = 3;
+
+        //Ignore any attached value
+        StrRef opt(str.data(), std::min(attached_value_pos(str), str.size()));
+
+        //Allow more edits for longer options, but not so many that everything matches
+        size_t max_distance = 1;
+        if (opt.size >= 12) {
+            max_distance = 3;
+        } else if (opt.size >= 5) {
+            max_distance = 2;
+        }
+
+        std::vector<std::string> suggestions;
+        if (opt.size > 2) {
+            //Every short option is within one edit of an unknown short option (e.g. '-z'), so
+            //only longer options are matched by edit distance
+            for (const auto& match : option_trie_.find_within_distance(opt, max_distance)) {
+                if (suggestions.size() == MAX_SUGGESTIONS) break;
+                suggestions.push_back(option_strs_[match.first]);
+            }
+        }
+
+        if (suggestions.empty()) {
+            //Perhaps an abbreviation. Counted first, so short prefixes (which match much of
+            //the trie) are rejected without collecting their keys.
+            size_t first_key;
+            size_t num_matches = option_trie_.count_prefix_matches(opt, first_key);
+            if (num_matches > 0 && num_matches <= MAX_SUGGESTIONS) {
+                for (size_t key : option_trie_.prefix_matches(opt)) {
+                    suggestions.push_back(option_strs_[key]);
+                }
+            }
+        }
+        return suggestions;
+    }
+
+    size_t OptionIndex::attached_value_pos(const std::string& str) const {
+        if (str.size() < 3 || str[0] != '-' || str[1] != '-') {
+            return std::string::npos;
+        }
+        return str.find('=', 2);
+    }
+
+    bool OptionIndex::is_option(const std::string& str, bool allow_abbrev) const {
+        if (str.size() < 2 || str[0] != '-') {
+            return false;
+        }
+
+        if (find(StrRef(str))) {
+            //Exact match to short/long option
+            return true;
+        }
+
+        if (str[1] != '-' && find_short(str[1])) {
+            //Short option with an attached value, or packed short options
+            return true;
+        }
+
+        size_t eq_pos = attached_value_pos(str);
+        if (eq_pos != std::string::npos && find(StrRef(str.data(), eq_pos))) {
+            return true;
+        }
+
+        if (allow_abbrev && str.size() > 2 && str[1] == '-') {
+            //Abbreviated long option (potentially with an attached value)
+            size_t first_key;
+            size_t prefix_len = std::min(eq_pos, str.size());
+            return option_trie_.count_prefix_matches(StrRef(str.data(), prefix_len), first_key) > 0;
+        }
+        return false;
+    }
+
+} //namespace
@@ -0,0 +1,81 @@
+#ifndef ARGPARSE_OPTION_INDEX_HPP
+#define ARGPARSE_OPTION_INDEX_HPP
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "argparse_util.hpp"
+#include "argparse_trie.hpp"
+
+namespace argparse {
+    class Argument;
+
+    /*
+     * OptionIndex maps option strings (e.g. '--foo', '-f') to their associated Argument
+     *
+     * Look-ups are performed on character ranges, so sub-strings of command-line
+     * tokens (e.g. the 'name' part of '--name=value') can be found without copying.
+     * Single character options are additionally kept in a directly indexed table,
+     * so packed short options (e.g. '-xvf') are decoded without hashing.
+     */
+    class OptionIndex {
+        public:
+            //Initializes an empty index, whose storage is allocated from resource
+            explicit OptionIndex(MemoryResource* resource=new_delete_resource());
+
+            //Rebuilds the index from the specified arguments (positional arguments are skipped)
+            // Throws ArgParseError if an option string maps to multiple arguments
+            void build(const PmrVector<std::shared_ptr<Argument>>& arguments);
+
+            //Returns the argument associated with opt (or nullptr if there is none)
+            std::shared_ptr<Argument> find(StrRef opt) const;
+
+            //Returns the argument associated with the single character option '-c' (or nullptr if there is none)
+            std::shared_ptr<Argument> find_short(char c) const {
+                unsigned char idx = static_cast<unsigned char>(c);
+                if (idx >= short_options_.size()) return nullptr;
+                return short_options_[idx];
+            }
+
+            //Returns the argument associated with the option part of a '--name=value' string,
+            //and sets value to the part after the '='. Returns nullptr if str is not of that form
+            //or the name is not a known option.
+            std::shared_ptr<Argument> find_with_attached_value(const std::string& str, std::string& value) const;
+
+            //Returns the argument whose long option uniquely starts with prefix (or nullptr if none do)
+            // Throws ArgParseError listing the candidates if the prefix is ambiguous
+            std::shared_ptr<Argument> find_abbreviation(StrRef prefix) const;
+
+            //Returns all option strings starting with prefix (in sorted order)
+            std::vector<std::string> options_with_prefix(StrRef prefix) const;
+
+            //Returns the options most similar to the (unrecognized) option string str,
+            //in order of decreasing similarity
+            std::vector<std::string> suggest(const std::string& str) const;
+
+            //Returns true if str represents a known option, either exactly, as a short option
+            //with an attached value (e.g. '-j3'), or as a long option with an attached value
+            //(e.g. '--foo=bar'). If allow_abbrev is true, abbreviated long options (e.g. '--fo'
+            //or '--fo=bar') are also considered.
+            bool is_option(const std::string& str, bool allow_abbrev=false) const;
+
+        private:
+            //Returns the position of the '=' in a '--name=value' string (or npos)
+            size_t attached_value_pos(const std::string& str) const;
+
+        private:
+            PmrVector<std::string> option_strs_; //Owns the strings referenced by the keys of str_to_option_arg_
+            PmrVector<std::shared_ptr<Argument>> option_args_; //Argument associated with each of option_strs_
+            PmrUnorderedMap<StrRef,std::shared_ptr<Argument>,StrRefHash> str_to_option_arg_;
+
+            //Single character options (e.g. '-j') directly indexed by their (ASCII) character
+            std::array<std::shared_ptr<Argument>,128> short_options_;
+
+            //Trie over option_strs_, used to resolve abbreviated long options
+            PrefixTrie option_trie_;
+    };
+
+} //namespace
+#endif
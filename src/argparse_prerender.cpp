@@ -0,0 +1,397 @@
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "argparse.hpp"
+#include "argparse_util.hpp"
+
+namespace argparse {
+
+    size_t write_long_option(FormatSink& sink, const Argument& argument);
+    size_t write_short_option(FormatSink& sink, const Argument& argument);
+    void write_roff_escaped(FormatSink& sink, const std::string& str);
+    void write_markdown_escaped(FormatSink& sink, const std::string& str);
+    void write_c_string_literal(std::ostream& os, const char* name, const std::string& str);
+    std::string option_names(const Argument& arg);
+    std::string usage_without_prefix(const std::string& usage);
+    bool is_c_identifier(const std::string& str);
+
+    void ArgumentParser::write_man_page(FormatSink& sink) {
+        add_help_option_if_unspecified();
+
+        std::string upper_prog = prog();
+        for (char& c : upper_prog) {
+            c = std::toupper(static_cast<unsigned char>(c));
+        }
+
+        sink.write(".TH \"");
+        write_roff_escaped(sink, upper_prog);
+        sink.write("\" 1\n");
+
+        sink.write(".SH NAME\n");
+        write_roff_escaped(sink, prog());
+        if (!description().empty()) {
+            sink.write(" \\- ");
+            write_roff_escaped(sink, description());
+        }
+        sink.write('\n');
+
+        //The usage is shown as the formatter wrapped it, without the 'usage: ' prefix
+        sink.write(".SH SYNOPSIS\n.nf\n");
+        write_roff_escaped(sink, usage_without_prefix(formatter().format_usage()));
+        sink.write(".fi\n");
+
+        if (!description().empty()) {
+            sink.write(".SH DESCRIPTION\n");
+            write_roff_escaped(sink, description());
+            sink.write('\n');
+        }
+
+        bool any_args = false;
+        for (const auto& group : argument_groups_view()) {
+            if (group.arguments().empty()) continue;
+
+            if (!any_args) {
+                sink.write(".SH OPTIONS\n");
+                any_args = true;
+            }
+            sink.write(".SS \"");
+            write_roff_escaped(sink, group.name());
+            sink.write("\"\n");
+            for (const auto& arg : group.arguments()) {
+                sink.write(".TP\n\\fB");
+                write_roff_escaped(sink, option_names(*arg));
+                sink.write("\\fR\n");
+                write_roff_escaped(sink, arg->help());
+                if (arg->default_set() && !arg->default_value().empty()) {
+                    if (!arg->help().empty()) {
+                        sink.write(' ');
+                    }
+                    sink.write("(Default: ");
+                    write_roff_escaped(sink, arg->default_value());
+                    sink.write(')');
+                }
+                sink.write('\n');
+            }
+            if (!group.epilog().empty()) {
+                sink.write(".PP\n");
+                write_roff_escaped(sink, group.epilog());
+                sink.write('\n');
+            }
+        }
+
+        auto subcommands = subparsers();
+        if (subcommands) {
+            sink.write(".SH \"");
+            std::string upper_title = subcommands->title();
+            for (char& c : upper_title) {
+                c = std::toupper(static_cast<unsigned char>(c));
+            }
+            write_roff_escaped(sink, upper_title);
+            sink.write("\"\n");
+            for (const auto& name : subcommands->names()) {
+                sink.write(".TP\n\\fB");
+                write_roff_escaped(sink, name);
+                sink.write("\\fR\n");
+                write_roff_escaped(sink, subcommands->help(name));
+                sink.write('\n');
+            }
+        }
+
+        if (!epilog().empty()) {
+            sink.write(".PP\n");
+            write_roff_escaped(sink, epilog());
+            sink.write('\n');
+        }
+        sink.flush();
+    }
+
+    void ArgumentParser::write_markdown(FormatSink& sink) {
+        add_help_option_if_unspecified();
+
+        sink.write("# ");
+        write_markdown_escaped(sink, prog());
+        sink.write("\n\n");
+
+        if (!description().empty()) {
+            write_markdown_escaped(sink, description());
+            sink.write("\n\n");
+        }
+
+        sink.write("```\n");
+        sink.write(formatter().format_usage());
+        sink.write("```\n");
+
+        for (const auto& group : argument_groups_view()) {
+            if (group.arguments().empty()) continue;
+
+            sink.write("\n## ");
+            write_markdown_escaped(sink, group.name());
+            sink.write("\n\n");
+            for (const auto& arg : group.arguments()) {
+                sink.write("- `");
+                sink.write(option_names(*arg));
+                sink.write('`');
+                if (!arg->help().empty()) {
+                    sink.write(": ");
+                    write_markdown_escaped(sink, arg->help());
+                }
+                if (arg->default_set() && !arg->default_value().empty()) {
+                    sink.write(" (Default: `");
+                    sink.write(arg->default_value());
+                    sink.write("`)");
+                }
+                sink.write('\n');
+            }
+            if (!group.epilog().empty()) {
+                sink.write('\n');
+                write_markdown_escaped(sink, group.epilog());
+                sink.write('\n');
+            }
+        }
+
+        auto subcommands = subparsers();
+        if (subcommands) {
+            sink.write("\n## ");
+            write_markdown_escaped(sink, subcommands->title());
+            sink.write("\n\n");
+            for (const auto& name : subcommands->names()) {
+                sink.write("- `");
+                sink.write(name);
+                sink.write('`');
+                if (!subcommands->help(name).empty()) {
+                    sink.write(": ");
+                    write_markdown_escaped(sink, subcommands->help(name));
+                }
+                sink.write('\n');
+            }
+        }
+
+        if (!epilog().empty()) {
+            sink.write('\n');
+            write_markdown_escaped(sink, epilog());
+            sink.write('\n');
+        }
+        sink.flush();
+    }
+
+    void ArgumentParser::write_prerendered_help(std::ostream& os, const std::string& variable_name) {
+        if (!is_c_identifier(variable_name)) {
+            throw ArgParseError("Invalid pre-rendered help variable name '" + variable_name + "'");
+        }
+
+        add_help_option_if_unspecified();
+        auto& fmt = formatter();
+
+        std::string usage;
+        StringSink usage_sink(usage);
+        fmt.write_usage(usage_sink);
+
+        std::string help;
+        StringSink help_sink(help);
+        fmt.write_usage(help_sink);
+        fmt.write_description(help_sink);
+        fmt.write_arguments(help_sink);
+        fmt.write_epilog(help_sink);
+
+        std::string man_page;
+        StringSink man_page_sink(man_page);
+        write_man_page(man_page_sink);
+
+        std::string markdown;
+        StringSink markdown_sink(markdown);
+        write_markdown(markdown_sink);
+
+        os << "//Generated by argparse::prerender_help_main() for '" << prog() << "', do not edit\n";
+        os << "#include \"argparse.hpp\"\n";
+        os << "\n";
+        os << "extern const argparse::PrerenderedHelp " << variable_name << ";\n";
+        os << "\n";
+        os << "const argparse::PrerenderedHelp " << variable_name << " = {\n";
+        os << "    " << schema_json_hash() << "ULL,\n";
+        write_c_string_literal(os, "usage", usage);
+        os << ",\n";
+        write_c_string_literal(os, "help", help);
+        os << ",\n";
+        write_c_string_literal(os, "man_page", man_page);
+        os << ",\n";
+        write_c_string_literal(os, "markdown", markdown);
+        os << "\n";
+        os << "};\n";
+    }
+
+    int prerender_help_main(int argc, const char* const* argv, ArgumentParser& parser) {
+        if (argc < 3 || argc > 4) {
+            std::cerr << "usage: " << (argc > 0 ? argv[0] : "prerender_help") << " OUTPUT_FILE VARIABLE_NAME [PROG]\n";
+            return 1;
+        }
+        std::string output_file = argv[1];
+        std::string variable_name = argv[2];
+        if (argc == 4) {
+            parser.prog(argv[3]);
+        }
+
+        std::string source;
+        try {
+            std::stringstream ss;
+            parser.write_prerendered_help(ss, variable_name);
+            source = ss.str();
+        } catch (const ArgParseError& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+
+        //Leave an unchanged file untouched, so its dependents are not rebuilt
+        {
+            std::ifstream existing(output_file, std::ios::binary);
+            if (existing) {
+                std::stringstream existing_ss;
+                existing_ss << existing.rdbuf();
+                if (existing_ss.str() == source) {
+                    return 0;
+                }
+            }
+        }
+
+        std::ofstream os(output_file, std::ios::binary | std::ios::trunc);
+        os << source;
+        os.close();
+        if (!os) {
+            std::cerr << "Error: Failed to write '" << output_file << "'\n";
+            std::remove(output_file.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    /*
+     * Utilities
+     */
+    //Writes str as roff text: escaping backslashes and hyphens (which would otherwise be
+    //rendered as typographic hyphens), and protecting lines which would be taken as requests
+    void write_roff_escaped(FormatSink& sink, const std::string& str) {
+        bool line_start = true;
+        for (char c : str) {
+            if (line_start && (c == '.' || c == '\'')) {
+                sink.write("\\&");
+            }
+            if (c == '\\') {
+                sink.write("\\e");
+            } else if (c == '-') {
+                sink.write("\\-");
+            } else {
+                sink.write(c);
+            }
+            line_start = (c == '\n');
+        }
+    }
+
+    //Writes str as Markdown text, escaping characters which would otherwise be taken as markup
+    void write_markdown_escaped(FormatSink& sink, const std::string& str) {
+        for (char c : str) {
+            switch (c) {
+                case '\\': case '`': case '*': case '_':
+                case '[': case ']': case '<': case '>':
+                    sink.write('\\');
+                    break;
+                default:
+                    break;
+            }
+            sink.write(c);
+        }
+    }
+
+    //Writes str as a C string literal, split into one piece per line so the generated source is readable
+    void write_c_string_literal(std::ostream& os, const char* name, const std::string& str) {
+        os << "    //" << name << "\n";
+        os << "    \"";
+        for (size_t i = 0; i < str.size(); ++i) {
+            unsigned char c = str[i];
+            if (c == '\n') {
+                os << "\\n\"";
+                if (i + 1 < str.size()) {
+                    os << "\n    \"";
+                }
+                continue;
+            } else if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            } else if (c == '?') {
+                os << "\\?"; //Avoid forming trigraphs
+            } else if (c == '\t') {
+                os << "\\t";
+            } else if (c < 0x20 || c >= 0x7f) {
+                //Always three octal digits, so a following digit is not absorbed into the escape
+                char octal[5];
+                std::snprintf(octal, sizeof(octal), "\\%03o", c);
+                os << octal;
+            } else {
+                os << c;
+            }
+            if (i + 1 == str.size()) {
+                os << '"';
+            }
+        }
+        if (str.empty()) {
+            os << '"';
+        }
+    }
+
+    //Returns the argument's option names (with metavars) as shown in the help, e.g. '-v LEVEL, --verbosity LEVEL'
+    std::string option_names(const Argument& arg) {
+        std::string str;
+        StringSink sink(str);
+
+        bool has_short_opt = !arg.short_option().empty();
+        if (has_short_opt) {
+            write_short_option(sink, arg);
+        }
+        if (!arg.long_option().empty() || (arg.nargs() != '0' && !arg.positional())) {
+            if (has_short_opt) {
+                sink.write(", ");
+            }
+            write_long_option(sink, arg);
+        }
+        return str;
+    }
+
+    //Returns usage with its leading 'usage: ' (and the matching indentation of continuation lines) removed
+    std::string usage_without_prefix(const std::string& usage) {
+        const std::string prefix = "usage: ";
+        if (usage.compare(0, prefix.size(), prefix) != 0) {
+            return usage;
+        }
+
+        std::string str;
+        size_t pos = prefix.size();
+        while (pos < usage.size()) {
+            size_t end = usage.find('\n', pos);
+            end = (end == std::string::npos) ? usage.size() : end + 1;
+            if (!str.empty()) {
+                //Continuation lines are indented to align with the text after the prefix
+                size_t num_spaces = 0;
+                while (num_spaces < prefix.size() && pos + num_spaces < end && usage[pos + num_spaces] == ' ') {
+                    ++num_spaces;
+                }
+                pos += num_spaces;
+            }
+            str.append(usage, pos, end - pos);
+            pos = end;
+        }
+        return str;
+    }
+
+    bool is_c_identifier(const std::string& str) {
+        if (str.empty() || std::isdigit(static_cast<unsigned char>(str[0]))) {
+            return false;
+        }
+        for (char c : str) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} //namespace
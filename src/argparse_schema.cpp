@@ -0,0 +1,260 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <streambuf>
+
+#ifdef _WIN32
+# include <process.h>
+#else
+# include <unistd.h>
+#endif
+
+#include "argparse.hpp"
+#include "argparse_json.hpp"
+#include "argparse_snapshot.hpp"
+
+namespace argparse {
+
+    std::string action_name(Action action);
+    std::string show_in_name(ShowIn show_in);
+
+    namespace {
+        //Hashes all characters written to it, without storing them
+        class HashStreambuf : public std::streambuf {
+            public:
+                uint64_t hash() const { return hasher_.hash(); }
+            protected:
+                int_type overflow(int_type c) override {
+                    if (c != traits_type::eof()) {
+                        char ch = traits_type::to_char_type(c);
+                        hasher_.update(&ch, 1);
+                    }
+                    return traits_type::not_eof(c);
+                }
+
+                std::streamsize xsputn(const char* s, std::streamsize n) override {
+                    hasher_.update(s, n);
+                    return n;
+                }
+            private:
+                Fnv1aHasher hasher_;
+        };
+    }
+
+    /*
+     * Binary schema layout (native byte order, strings length prefixed):
+     *
+     *   char[8]  magic
+     *   uint32_t format version
+     *   string   prog, description, version, epilog
+     *   uint32_t number of groups, each:
+     *     string   name, epilog
+     *     uint32_t number of arguments, each:
+     *       string   long option, short option, help, metavar, type name
+     *       uint8_t  nargs
+     *       uint32_t number of values (if nargs is 'N')
+     *       uint8_t  action, required, show_in, has default
+     *       string   default (if has default)
+     *       uint32_t number of choices, each a string
+     *   uint32_t number of subcommands, each:
+     *     string   name, help
+     */
+    constexpr char SCHEMA_MAGIC[8] = {'A', 'R', 'G', 'P', 'S', 'C', 'H', 'M'};
+    constexpr uint32_t SCHEMA_VERSION = 2;
+
+    void ArgumentParser::write_schema_json(std::ostream& os) {
+        add_help_option_if_unspecified();
+
+        JsonWriter writer(os);
+        writer.begin_object();
+        writer.key("prog"); writer.value(prog());
+        writer.key("description"); writer.value(description());
+        writer.key("version"); writer.value(version());
+        writer.key("epilog"); writer.value(epilog());
+
+        writer.key("groups");
+        writer.begin_array();
+        for (const auto& group : argument_groups_) {
+            writer.begin_object();
+            writer.key("name"); writer.value(group.name());
+            writer.key("epilog"); writer.value(group.epilog());
+
+            writer.key("arguments");
+            writer.begin_array();
+            for (const auto& arg : group.arguments()) {
+                writer.begin_object();
+                writer.key("long_option"); writer.value(arg->long_option());
+                writer.key("short_option"); writer.value(arg->short_option());
+                writer.key("positional"); writer.value(arg->positional());
+                writer.key("help"); writer.value(arg->help());
+                writer.key("metavar"); writer.value(arg->metavar());
+                if (arg->nargs() == 'N') {
+                    writer.key("nargs"); writer.value(std::to_string(arg->num_values()));
+                } else {
+                    writer.key("nargs"); writer.value(std::string(1, arg->nargs()));
+                }
+                writer.key("action"); writer.value(action_name(arg->action()));
+                writer.key("required"); writer.value(arg->required());
+                writer.key("choices"); writer.value(arg->choices());
+                writer.key("default");
+                if (arg->default_set()) {
+                    writer.value(arg->default_value());
+                } else {
+                    writer.null();
+                }
+                writer.key("show_in"); writer.value(show_in_name(arg->show_in()));
+                writer.key("type"); writer.value(arg->type_name());
+                writer.end_object();
+            }
+            writer.end_array();
+
+            writer.end_object();
+        }
+        writer.end_array();
+
+        if (subparsers_) {
+            //Only the names are described, so no subcommand parsers need be constructed
+            writer.key("subcommands");
+            writer.begin_object();
+            writer.key("title"); writer.value(subparsers_->title());
+            writer.key("required"); writer.value(subparsers_->required());
+            writer.key("commands");
+            writer.begin_array();
+            for (const auto& name : subparsers_->names()) {
+                writer.begin_object();
+                writer.key("name"); writer.value(name);
+                writer.key("help"); writer.value(subparsers_->help(name));
+                writer.end_object();
+            }
+            writer.end_array();
+            writer.end_object();
+        }
+
+        writer.end_object();
+        os << "\n";
+    }
+
+    void ArgumentParser::write_schema_binary(std::ostream& os) {
+        add_help_option_if_unspecified();
+
+        std::string buf;
+        SnapshotWriter writer(buf);
+        writer.write_bytes(SCHEMA_MAGIC, sizeof(SCHEMA_MAGIC));
+        writer.write_pod(SCHEMA_VERSION);
+        writer.write_string(prog());
+        writer.write_string(description());
+        writer.write_string(version());
+        writer.write_string(epilog());
+
+        writer.write_pod<uint32_t>(argument_groups_.size());
+        for (const auto& group : argument_groups_) {
+            writer.write_string(group.name());
+            writer.write_string(group.epilog());
+
+            writer.write_pod<uint32_t>(group.arguments().size());
+            for (const auto& arg : group.arguments()) {
+                writer.write_string(arg->long_option());
+                writer.write_string(arg->short_option());
+                writer.write_string(arg->help());
+                writer.write_string(arg->metavar());
+                writer.write_string(arg->type_name());
+                writer.write_pod<uint8_t>(arg->nargs());
+                if (arg->nargs() == 'N') {
+                    writer.write_pod<uint32_t>(arg->num_values());
+                }
+                writer.write_pod<uint8_t>(static_cast<uint8_t>(arg->action()));
+                writer.write_pod<uint8_t>(arg->required());
+                writer.write_pod<uint8_t>(static_cast<uint8_t>(arg->show_in()));
+                writer.write_pod<uint8_t>(arg->default_set());
+                if (arg->default_set()) {
+                    writer.write_string(arg->default_value());
+                }
+
+                auto choices = arg->choices();
+                writer.write_pod<uint32_t>(choices.size());
+                for (const auto& choice : choices) {
+                    writer.write_string(choice);
+                }
+            }
+        }
+
+        std::vector<std::string> subcommand_names;
+        if (subparsers_) {
+            subcommand_names = subparsers_->names();
+        }
+        writer.write_pod<uint32_t>(subcommand_names.size());
+        for (const auto& name : subcommand_names) {
+            writer.write_string(name);
+            writer.write_string(subparsers_->help(name));
+        }
+
+        os.write(buf.data(), buf.size());
+    }
+
+    uint64_t ArgumentParser::schema_json_hash() {
+        HashStreambuf hash_buf;
+        std::ostream hash_os(&hash_buf);
+        write_schema_json(hash_os);
+        return hash_buf.hash();
+    }
+
+    std::string ArgumentParser::write_schema_cache(const std::string& cache_dir) {
+        //Key the cache by the schema's content, so any change produces a new file
+        std::stringstream filename;
+        filename << cache_dir << "/" << basename(prog()) << "."
+                 << std::hex << std::setw(16) << std::setfill('0') << schema_json_hash() << ".json";
+        std::string path = filename.str();
+
+        if (std::ifstream(path).good()) {
+            //Already cached
+            return path;
+        }
+
+        //Write to a temporary file first, so readers never observe a partially written schema.
+        //It is named uniquely (by process and call), so concurrent writers never share one.
+        static std::atomic<unsigned> num_tmp_files(0);
+#ifdef _WIN32
+        int pid = _getpid();
+#else
+        int pid = ::getpid();
+#endif
+        std::string tmp_path = path + "." + std::to_string(pid) + "." + std::to_string(num_tmp_files++) + ".tmp";
+        {
+            std::ofstream os(tmp_path);
+            if (!os) {
+                throw ArgParseError("Failed to write schema cache '" + tmp_path + "'");
+            }
+            write_schema_json(os);
+        }
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            throw ArgParseError("Failed to write schema cache '" + path + "'");
+        }
+        return path;
+    }
+
+    /*
+     * Utilities
+     */
+    std::string action_name(Action action) {
+        switch (action) {
+            case Action::STORE: return "store";
+            case Action::STORE_TRUE: return "store_true";
+            case Action::STORE_FALSE: return "store_false";
+            case Action::HELP: return "help";
+            case Action::VERSION: return "version";
+            default: throw ArgParseError("Unrecognized action");
+        }
+    }
+
+    std::string show_in_name(ShowIn show_in) {
+        switch (show_in) {
+            case ShowIn::USAGE_AND_HELP: return "usage_and_help";
+            case ShowIn::HELP_ONLY: return "help_only";
+            default: throw ArgParseError("Unrecognized show_in");
+        }
+    }
+
+} //namespace
@@ -0,0 +1,377 @@
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "argparse_server.hpp"
+
+namespace argparse {
+
+    namespace {
+        void write_all(int fd, const char* data, size_t size, int timeout_ms=-1, int stop_fd=-1);
+        void read_all(int fd, char* data, size_t size);
+        sockaddr_un socket_address(const std::string& socket_path);
+    }
+
+    constexpr size_t VALIDATION_READ_SIZE = 64 * 1024;
+    constexpr size_t MAX_VALIDATION_READ_PER_EVENT = 4 * VALIDATION_READ_SIZE; //Before serving other connections
+    constexpr int VALIDATION_WRITE_TIMEOUT_MS = 5000; //For a client to accept more of its responses
+    constexpr uint8_t VALIDATION_PASSED = 0;
+    constexpr uint8_t VALIDATION_FAILED = 1;
+
+    struct ValidationServer::Connection {
+        int fd;
+        std::vector<char> buffer; //Input not yet answered, starting at a request
+        size_t size = 0;
+        std::string responses; //Re-used to gather the responses to each read
+    };
+
+    /*
+     * ValidationServer
+     */
+    ValidationServer::ValidationServer(std::string socket_path, ParserFactory factory, size_t num_workers)
+        : socket_path_(socket_path) {
+        if (num_workers == 0) {
+            throw ArgParseError("Validation server requires at least one worker");
+        }
+        for (size_t i = 0; i < num_workers; ++i) {
+            parsers_.push_back(factory());
+        }
+
+        sockaddr_un addr = socket_address(socket_path_);
+
+        //Replace a socket left by a previous server, but nothing else
+        struct stat path_stat;
+        if (::lstat(socket_path_.c_str(), &path_stat) == 0 && S_ISSOCK(path_stat.st_mode)) {
+            ::unlink(socket_path_.c_str());
+        }
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        stop_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (listen_fd_ < 0 || epoll_fd_ < 0 || stop_fd_ < 0
+            || ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || ::listen(listen_fd_, SOMAXCONN) != 0) {
+            std::string msg = "Failed to listen on '" + socket_path_ + "' (" + std::strerror(errno) + ")";
+            if (listen_fd_ >= 0) ::close(listen_fd_);
+            if (epoll_fd_ >= 0) ::close(epoll_fd_);
+            if (stop_fd_ >= 0) ::close(stop_fd_);
+            throw ArgParseError(msg);
+        }
+
+        //The stop event is level triggered, so it wakes every worker
+        epoll_event stop_event = {};
+        stop_event.events = EPOLLIN;
+        stop_event.data.ptr = &stop_fd_;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &stop_event);
+
+        epoll_event listen_event = {};
+        listen_event.events = EPOLLIN | EPOLLONESHOT;
+        listen_event.data.ptr = &listen_fd_;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event);
+    }
+
+    ValidationServer::~ValidationServer() {
+        for (Connection* conn : connections_) {
+            ::close(conn->fd);
+            delete conn;
+        }
+        ::close(listen_fd_);
+        ::close(epoll_fd_);
+        ::close(stop_fd_);
+        ::unlink(socket_path_.c_str());
+    }
+
+    void ValidationServer::serve() {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < parsers_.size(); ++i) {
+            ArgumentParser& parser = *parsers_[i];
+            workers.emplace_back([this, &parser]() { run_worker(parser); });
+        }
+        run_worker(*parsers_[0]);
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void ValidationServer::stop() {
+        uint64_t one = 1;
+        ssize_t written = ::write(stop_fd_, &one, sizeof(one));
+        (void) written; //Only fails if already stopped (the counter is saturated)
+    }
+
+    const std::string& ValidationServer::socket_path() const { return socket_path_; }
+
+    size_t ValidationServer::num_requests() const { return num_requests_; }
+
+    void ValidationServer::run_worker(ArgumentParser& parser) {
+        std::vector<std::string> arg_strs; //Re-used for each request
+
+        while (true) {
+            //One event at a time, so ready connections are spread across the workers
+            epoll_event event;
+            int num_events = ::epoll_wait(epoll_fd_, &event, 1, -1);
+            if (num_events < 0) {
+                if (errno == EINTR) continue;
+                return;
+            } else if (num_events == 0) {
+                continue;
+            }
+
+            if (event.data.ptr == &stop_fd_) {
+                return;
+            } else if (event.data.ptr == &listen_fd_) {
+                accept_connections();
+                rearm(listen_fd_, &listen_fd_);
+            } else {
+                Connection* conn = static_cast<Connection*>(event.data.ptr);
+                if (serve_connection(*conn, parser, arg_strs)) {
+                    rearm(conn->fd, conn);
+                } else {
+                    close_connection(conn);
+                }
+            }
+        }
+    }
+
+    void ValidationServer::accept_connections() {
+        while (true) {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return; //EAGAIN once all pending connections are accepted, or out of descriptors
+            }
+
+            Connection* conn = new Connection;
+            conn->fd = fd;
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex_);
+                connections_.insert(conn);
+            }
+
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+            event.data.ptr = conn;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close_connection(conn);
+            }
+        }
+    }
+
+    bool ValidationServer::serve_connection(Connection& conn, ArgumentParser& parser, std::vector<std::string>& arg_strs) {
+        conn.responses.clear();
+
+        //Answer requests as they arrive, until the client has no more input for now, or the
+        //connection has had its share of this worker (the connection stays readable, so its
+        //re-armed event fires again once other connections have been served)
+        bool open = true;
+        size_t num_read_total = 0;
+        while (open && num_read_total < MAX_VALIDATION_READ_PER_EVENT) {
+            if (conn.buffer.size() - conn.size < VALIDATION_READ_SIZE) {
+                conn.buffer.resize(conn.size + VALIDATION_READ_SIZE);
+            }
+            ssize_t num_read = ::read(conn.fd, conn.buffer.data() + conn.size, conn.buffer.size() - conn.size);
+            if (num_read < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) break;
+                return false;
+            }
+            open = (num_read > 0);
+            conn.size += num_read;
+            num_read_total += num_read;
+
+            //Checked after every read, so an invalid frame header is rejected before its payload is buffered
+            if (!answer_requests(conn, parser, arg_strs)) {
+                return false;
+            }
+        }
+
+        if (conn.buffer.size() > 2 * VALIDATION_READ_SIZE && conn.size < VALIDATION_READ_SIZE) {
+            //Release the space used by an unusually large request
+            conn.buffer.resize(VALIDATION_READ_SIZE);
+            conn.buffer.shrink_to_fit();
+        }
+
+        try {
+            //Bounded, and abandoned on stop(), so a client which stops reading can not hold the worker
+            write_all(conn.fd, conn.responses.data(), conn.responses.size(), VALIDATION_WRITE_TIMEOUT_MS, stop_fd_);
+        } catch (const ArgParseError&) {
+            return false;
+        }
+        return open;
+    }
+
+    bool ValidationServer::answer_requests(Connection& conn, ArgumentParser& parser, std::vector<std::string>& arg_strs) {
+        size_t pos = 0;
+        while (conn.size - pos >= sizeof(uint32_t)) {
+            uint32_t payload_size;
+            std::memcpy(&payload_size, conn.buffer.data() + pos, sizeof(payload_size));
+            if (payload_size > MAX_VALIDATION_FRAME_SIZE) {
+                return false;
+            }
+            if (conn.size - pos - sizeof(uint32_t) < payload_size) break; //Incomplete
+
+            const char* payload = conn.buffer.data() + pos + sizeof(uint32_t);
+            pos += sizeof(uint32_t) + payload_size;
+
+            //Split the arguments in place
+            size_t num_args = 0;
+            for (size_t begin = 0; begin < payload_size; ++num_args) {
+                const void* nul = std::memchr(payload + begin, '\0', payload_size - begin);
+                size_t end = nul ? static_cast<const char*>(nul) - payload : payload_size;
+                if (num_args == arg_strs.size()) {
+                    arg_strs.emplace_back();
+                }
+                arg_strs[num_args].assign(payload + begin, end - begin);
+                begin = end + 1;
+            }
+            arg_strs.resize(num_args);
+
+            std::string error;
+            try {
+                parser.parse_args_throw(arg_strs);
+            } catch (const ArgParseError& e) {
+                error = e.what();
+            } catch (const ArgParseHelp&) {
+                error = "Unexpected request for help";
+            } catch (const ArgParseVersion&) {
+                error = "Unexpected request for the version";
+            }
+            ++num_requests_;
+
+            uint32_t response_size = 1 + error.size();
+            conn.responses.append(reinterpret_cast<const char*>(&response_size), sizeof(response_size));
+            conn.responses.push_back(error.empty() ? VALIDATION_PASSED : VALIDATION_FAILED);
+            conn.responses += error;
+        }
+
+        //Keep any incomplete request for the next read
+        std::memmove(conn.buffer.data(), conn.buffer.data() + pos, conn.size - pos);
+        conn.size -= pos;
+        return true;
+    }
+
+    void ValidationServer::rearm(int fd, void* data) {
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        if (data != &listen_fd_) {
+            event.events |= EPOLLRDHUP;
+        }
+        event.data.ptr = data;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+    }
+
+    void ValidationServer::close_connection(Connection* conn) {
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.erase(conn);
+        }
+        ::close(conn->fd); //Also removes it from the epoll instance
+        delete conn;
+    }
+
+    /*
+     * ValidationClient
+     */
+    ValidationClient::ValidationClient(const std::string& socket_path) {
+        sockaddr_un addr = socket_address(socket_path);
+
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            std::string msg = "Failed to connect to '" + socket_path + "' (" + std::strerror(errno) + ")";
+            if (fd_ >= 0) ::close(fd_);
+            throw ArgParseError(msg);
+        }
+    }
+
+    ValidationClient::~ValidationClient() {
+        ::close(fd_);
+    }
+
+    bool ValidationClient::validate(const std::vector<std::string>& args, std::string* error) {
+        request_.assign(sizeof(uint32_t), '\0');
+        for (const auto& arg : args) {
+            request_ += arg;
+            request_ += '\0';
+        }
+        uint32_t payload_size = request_.size() - sizeof(uint32_t);
+        std::memcpy(&request_[0], &payload_size, sizeof(payload_size));
+        write_all(fd_, request_.data(), request_.size());
+
+        uint32_t response_size;
+        read_all(fd_, reinterpret_cast<char*>(&response_size), sizeof(response_size));
+        if (response_size < 1 || response_size > MAX_VALIDATION_FRAME_SIZE) {
+            throw ArgParseError("Invalid response from validation server");
+        }
+        response_.resize(response_size);
+        read_all(fd_, response_.data(), response_size);
+
+        bool passed = (response_[0] == VALIDATION_PASSED);
+        if (error) {
+            error->assign(response_.data() + 1, response_size - 1);
+        }
+        return passed;
+    }
+
+    /*
+     * Utilities
+     */
+    namespace {
+        //Writes all of data to fd, waiting for it to become writable if required. Throws ArgParseError
+        //if any wait exceeds timeout_ms (unless negative), or stop_fd (if valid) becomes readable.
+        void write_all(int fd, const char* data, size_t size, int timeout_ms, int stop_fd) {
+            while (size > 0) {
+                ssize_t num_written = ::send(fd, data, size, MSG_NOSIGNAL);
+                if (num_written < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN) {
+                        pollfd poll_fds[2] = {{fd, POLLOUT, 0}, {stop_fd, POLLIN, 0}}; //Negative fds are ignored
+                        int num_ready = ::poll(poll_fds, 2, timeout_ms);
+                        if (num_ready < 0 && errno == EINTR) continue;
+                        if (num_ready <= 0 || poll_fds[1].revents != 0) {
+                            throw ArgParseError("Validation socket not accepting writes");
+                        }
+                        continue;
+                    }
+                    throw ArgParseError(std::string("Failed to write to validation socket (") + std::strerror(errno) + ")");
+                }
+                data += num_written;
+                size -= num_written;
+            }
+        }
+
+        //Reads exactly size bytes from (blocking) fd
+        void read_all(int fd, char* data, size_t size) {
+            while (size > 0) {
+                ssize_t num_read = ::read(fd, data, size);
+                if (num_read < 0 && errno == EINTR) continue;
+                if (num_read <= 0) {
+                    throw ArgParseError("Validation connection closed unexpectedly");
+                }
+                data += num_read;
+                size -= num_read;
+            }
+        }
+
+        sockaddr_un socket_address(const std::string& socket_path) {
+            sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+                throw ArgParseError("Invalid validation socket path '" + socket_path + "'");
+            }
+            std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+            return addr;
+        }
+    }
+
+} //namespace
+#endif
@@ -0,0 +1,110 @@
+#ifndef ARGPARSE_SERVER_HPP
+#define ARGPARSE_SERVER_HPP
+#ifdef __linux__
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "argparse.hpp"
+
+namespace argparse {
+
+    /*
+     * Validation protocol
+     *
+     * Clients send framed command-lines over a Unix domain socket, and receive one
+     * framed response for each, in order. All integers are in native byte order.
+     *
+     *   request:  uint32_t payload size, then the arguments, each NUL terminated
+     *             (excluding the program name, as for parse_args_throw())
+     *   response: uint32_t payload size, then a uint8_t status (0 if the command-line
+     *             parsed, 1 if not) followed by the error message (empty if parsed)
+     */
+    constexpr uint32_t MAX_VALIDATION_FRAME_SIZE = 16 * 1024 * 1024;
+
+    //Creates a parser for a ValidationServer worker. Each worker parses into its own destinations,
+    //so the parser (e.g. a class derived from ArgumentParser) must own its destinations.
+    typedef std::function<std::shared_ptr<ArgumentParser>()> ParserFactory;
+
+    /*
+     * ValidationServer checks command-lines sent over a Unix domain socket against resident parsers
+     *
+     * Avoids starting a process (and defining its parser) for each command-line to be checked.
+     * Clients are served concurrently by a pool of worker threads, each with its own parser,
+     * which wait on a shared epoll instance. Connections are registered one-shot, so each is
+     * served by one worker at a time and its responses are sent in order. A worker reads a
+     * bounded amount from a connection before serving others, and drops connections which
+     * send invalid requests or stop reading their responses.
+     */
+    class ValidationServer {
+        public:
+            //Listens on socket_path (replacing any stale socket there), with num_workers parsers
+            //created by factory. Throws ArgParseError on failure.
+            ValidationServer(std::string socket_path, ParserFactory factory, size_t num_workers=4);
+            ~ValidationServer(); //Closes all connections and removes the socket
+
+            ValidationServer(const ValidationServer&) = delete;
+            ValidationServer& operator=(const ValidationServer&) = delete;
+
+            //Serves clients (on the calling thread and num_workers - 1 others) until stop() is called
+            void serve();
+
+            //Makes serve() return once each worker finishes its current request (dropping any
+            //connection whose responses are blocked). May be called from any thread, including before serve().
+            void stop();
+
+            const std::string& socket_path() const;
+
+            //Returns the number of command-lines checked
+            size_t num_requests() const;
+        private:
+            struct Connection;
+
+            void run_worker(ArgumentParser& parser);
+            void accept_connections();
+            //Reads and answers the connection's complete requests, returning false once it should be closed
+            bool serve_connection(Connection& conn, ArgumentParser& parser, std::vector<std::string>& arg_strs);
+            //Answers the complete requests buffered by conn (appending to its responses), returning false
+            //if a request is invalid
+            bool answer_requests(Connection& conn, ArgumentParser& parser, std::vector<std::string>& arg_strs);
+            void rearm(int fd, void* data);
+            void close_connection(Connection* conn);
+        private:
+            std::string socket_path_;
+            std::vector<std::shared_ptr<ArgumentParser>> parsers_;
+            int listen_fd_ = -1;
+            int epoll_fd_ = -1;
+            int stop_fd_ = -1; //eventfd, readable once stopped
+            std::atomic<size_t> num_requests_{0};
+
+            std::mutex connections_mutex_;
+            std::set<Connection*> connections_;
+    };
+
+    //Connection to a ValidationServer, used from one thread at a time
+    class ValidationClient {
+        public:
+            //Connects to the server listening on socket_path. Throws ArgParseError on failure.
+            explicit ValidationClient(const std::string& socket_path);
+            ~ValidationClient();
+
+            ValidationClient(const ValidationClient&) = delete;
+            ValidationClient& operator=(const ValidationClient&) = delete;
+
+            //Returns true if the server parsed args, otherwise false with the error message
+            //stored in error (if non-null). Throws ArgParseError if the connection fails.
+            bool validate(const std::vector<std::string>& args, std::string* error=nullptr);
+        private:
+            int fd_ = -1;
+            std::string request_; //Re-used for each request
+            std::vector<char> response_;
+    };
+
+} //namespace
+#endif
+#endif
@@ -0,0 +1,216 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+# include <iterator>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "argparse.hpp"
+#include "argparse_snapshot.hpp"
+
+namespace argparse {
+
+    /*
+     * Snapshot layout (native byte order):
+     *
+     *   char[8]  magic
+     *   uint32_t format version
+     *   uint32_t byte order mark
+     *   uint64_t schema hash
+     *   uint32_t number of records
+     *
+     * followed by one record for each argument whose destination is not UNSPECIFIED:
+     *
+     *   uint32_t argument index (in the parser's argument order)
+     *   uint8_t  provenance
+     *   uint32_t value size
+     *   char[]   value (as written by Argument::encode_dest())
+     */
+    constexpr char SNAPSHOT_MAGIC[8] = {'A', 'R', 'G', 'P', 'S', 'N', 'A', 'P'};
+    constexpr uint32_t SNAPSHOT_VERSION = 1;
+    constexpr uint32_t SNAPSHOT_BYTE_ORDER_MARK = 0x01020304;
+
+    namespace {
+#ifndef _WIN32
+        //Read-only memory mapping of a file, released on destruction
+        class MappedFile {
+            public:
+                MappedFile(const std::string& filename) {
+                    fd_ = ::open(filename.c_str(), O_RDONLY);
+                    if (fd_ < 0) {
+                        throw ArgParseError("Failed to open snapshot '" + filename + "'");
+                    }
+
+                    struct stat file_stat;
+                    if (::fstat(fd_, &file_stat) != 0) {
+                        throw ArgParseError("Failed to read snapshot '" + filename + "'");
+                    }
+                    size_ = file_stat.st_size;
+
+                    if (size_ > 0) {
+                        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+                        if (data == MAP_FAILED) {
+                            throw ArgParseError("Failed to map snapshot '" + filename + "'");
+                        }
+                        data_ = static_cast<const char*>(data);
+                    }
+                }
+
+                ~MappedFile() {
+                    if (data_) {
+                        ::munmap(const_cast<char*>(data_), size_);
+                    }
+                    if (fd_ >= 0) {
+                        ::close(fd_);
+                    }
+                }
+
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                const char* data() const { return data_; }
+                size_t size() const { return size_; }
+            private:
+                int fd_ = -1;
+                const char* data_ = nullptr;
+                size_t size_ = 0;
+        };
+#endif
+    }
+
+    void ArgumentParser::save_snapshot(std::ostream& os) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        std::string buf;
+        SnapshotWriter writer(buf);
+        writer.write_bytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writer.write_pod(SNAPSHOT_VERSION);
+        writer.write_pod(SNAPSHOT_BYTE_ORDER_MARK);
+        writer.write_pod(schema_hash());
+
+        uint32_t num_records = 0;
+        for (const auto& arg : arguments_) {
+            if (arg->dest_provenance() != Provenance::UNSPECIFIED) {
+                ++num_records;
+            }
+        }
+        writer.write_pod(num_records);
+
+        std::string value_buf;
+        for (uint32_t i = 0; i < arguments_.size(); ++i) {
+            const auto& arg = arguments_[i];
+            if (arg->dest_provenance() == Provenance::UNSPECIFIED) continue;
+
+            value_buf.clear();
+            SnapshotWriter value_writer(value_buf);
+            arg->encode_dest(value_writer);
+
+            writer.write_pod(i);
+            writer.write_pod(static_cast<uint8_t>(arg->dest_provenance()));
+            writer.write_string(value_buf);
+        }
+
+        os.write(buf.data(), buf.size());
+    }
+
+    void ArgumentParser::load_snapshot(const std::string& filename) {
+#ifdef _WIN32
+        std::ifstream is(filename, std::ios::binary);
+        if (!is) {
+            throw ArgParseError("Failed to open snapshot '" + filename + "'");
+        }
+        std::string buf((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        load_snapshot(buf.data(), buf.size());
+#else
+        MappedFile file(filename);
+        load_snapshot(file.data(), file.size());
+#endif
+    }
+
+    void ArgumentParser::load_snapshot(const char* data, size_t size) {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        SnapshotReader reader(data, size);
+        if (std::memcmp(reader.read_bytes(sizeof(SNAPSHOT_MAGIC)), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+            throw ArgParseError("Invalid snapshot (unrecognized format)");
+        }
+        uint32_t version = reader.read_pod<uint32_t>();
+        if (version != SNAPSHOT_VERSION) {
+            std::stringstream msg;
+            msg << "Unsupported snapshot version " << version << " (expected " << SNAPSHOT_VERSION << ")";
+            throw ArgParseError(msg.str());
+        }
+        if (reader.read_pod<uint32_t>() != SNAPSHOT_BYTE_ORDER_MARK) {
+            throw ArgParseError("Snapshot was saved on a platform with a different byte order");
+        }
+        if (reader.read_pod<uint64_t>() != schema_hash()) {
+            throw ArgParseError("Snapshot was saved by a parser with different arguments");
+        }
+
+        //Start from a clean state, as a parse would
+        active_subparser_ = nullptr;
+        parsed_ = false;
+        for (const auto& arg : arguments_) {
+            arg->reset_dest();
+        }
+        specified_.resize(arguments_.size());
+        string_arena_.reset();
+        StringArenaScope arena_scope(&string_arena_);
+
+        uint32_t num_records = reader.read_pod<uint32_t>();
+        for (uint32_t i = 0; i < num_records; ++i) {
+            uint32_t arg_idx = reader.read_pod<uint32_t>();
+            uint8_t prov = reader.read_pod<uint8_t>();
+            if (arg_idx >= arguments_.size() || prov > static_cast<uint8_t>(Provenance::INFERRED)) {
+                throw ArgParseError("Invalid snapshot (corrupt record)");
+            }
+            const auto& arg = arguments_[arg_idx];
+
+            uint32_t value_size = reader.read_pod<uint32_t>();
+            SnapshotReader value_reader(reader.read_bytes(value_size), value_size);
+            arg->decode_dest(value_reader, static_cast<Provenance>(prov));
+            if (value_reader.position() != value_reader.size()) {
+                throw ArgParseError("Invalid snapshot value for " + arg->name());
+            }
+
+            if (static_cast<Provenance>(prov) == Provenance::SPECIFIED) {
+                specified_.set(arg_idx);
+            }
+        }
+        if (reader.position() != reader.size()) {
+            throw ArgParseError("Invalid snapshot (unexpected trailing data)");
+        }
+        parsed_ = true;
+        live_arena_size_ = string_arena_.size();
+
+        update_changes(arguments_);
+    }
+
+    uint64_t ArgumentParser::schema_hash() {
+        add_help_option_if_unspecified();
+        update_option_index();
+
+        Fnv1aHasher hasher;
+        for (const auto& arg : arguments_) {
+            hasher.update(arg->long_option());
+            hasher.update(arg->short_option());
+            char nargs = arg->nargs();
+            hasher.update(&nargs, sizeof(nargs));
+            uint64_t num_values = arg->num_values();
+            hasher.update(&num_values, sizeof(num_values));
+            uint8_t action = static_cast<uint8_t>(arg->action());
+            hasher.update(&action, sizeof(action));
+            hasher.update(arg->dest_type());
+        }
+        return hasher.hash();
+    }
+
+} //namespace
@@ -0,0 +1,143 @@
+#ifndef ARGPARSE_SNAPSHOT_HPP
+#define ARGPARSE_SNAPSHOT_HPP
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "argparse_default_converter.hpp"
+#include "argparse_error.hpp"
+#include "argparse_value.hpp"
+
+namespace argparse {
+
+    //Appends binary encoded values to a buffer
+    class SnapshotWriter {
+        public:
+            SnapshotWriter(std::string& buf) : buf_(buf) {}
+
+            void write_bytes(const void* data, size_t size) {
+                buf_.append(static_cast<const char*>(data), size);
+            }
+
+            //Writes the (native) byte representation of a trivially copyable value
+            template<typename T>
+            void write_pod(const T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+                write_bytes(&value, sizeof(T));
+            }
+
+            //Writes a length prefixed string
+            void write_string(const std::string& str) {
+                write_pod<uint32_t>(str.size());
+                write_bytes(str.data(), str.size());
+            }
+        private:
+            std::string& buf_;
+    };
+
+    //Reads values written by SnapshotWriter from a (potentially unaligned) buffer
+    // Throws ArgParseError if reading past the end of the buffer
+    class SnapshotReader {
+        public:
+            SnapshotReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+            const char* read_bytes(size_t size) {
+                if (size > size_ - pos_) {
+                    throw ArgParseError("Truncated snapshot");
+                }
+                const char* bytes = data_ + pos_;
+                pos_ += size;
+                return bytes;
+            }
+
+            template<typename T>
+            T read_pod() {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+                T value;
+                std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string read_string() {
+                uint32_t size = read_pod<uint32_t>();
+                return std::string(read_bytes(size), size);
+            }
+
+            size_t position() const { return pos_; }
+            size_t size() const { return size_; }
+        private:
+            const char* data_;
+            size_t size_;
+            size_t pos_ = 0;
+    };
+
+    //Returns the string produced by a converter's to_str(), which may return either
+    //a ConvertedValue<std::string> or a plain std::string
+    inline std::string converted_str(const ConvertedValue<std::string>& converted) {
+        if (!converted.valid()) {
+            throw ArgParseConversionError(converted.error());
+        }
+        return converted.value();
+    }
+    inline std::string converted_str(const std::string& str) { return str; }
+
+    //Returns value converted to a string by Converter, to be converted back by its from_str()
+    template<typename T, typename Converter, typename Enable=void>
+    struct SnapshotStr {
+        static std::string str(const T& value) { return converted_str(Converter().to_str(value)); }
+    };
+
+    //Values converted by DefaultConverter (i.e. by their stream operators) are written with
+    //enough digits that any floating point values they contain convert back exactly. Unlike
+    //DefaultConverter::to_str(), whose output is shown to users (e.g. in help and dumps).
+    template<typename T>
+    struct SnapshotStr<T, DefaultConverter<T>, typename std::enable_if<!std::is_pointer<T>::value>::type> {
+        static std::string str(const T& value) {
+            std::stringstream ss;
+            ss.precision(std::numeric_limits<long double>::max_digits10);
+            ss << value;
+            if (ss.fail()) {
+                throw ArgParseConversionError("Invalid conversion of snapshot value to string");
+            }
+            return ss.str();
+        }
+    };
+
+    /*
+     * SnapshotCodec encodes values of type T in snapshots.
+     *
+     * Trivially copyable values (integers, floats, enums, bools) are stored as their
+     * raw bytes and strings as length prefixed bytes, so restoring them involves no
+     * string conversion. Anything else falls back to Converter's to_str()/from_str().
+     */
+    template<typename T, typename Converter, typename Enable=void>
+    struct SnapshotCodec {
+        static void encode(SnapshotWriter& writer, const T& value) {
+            writer.write_string(SnapshotStr<T,Converter>::str(value));
+        }
+
+        static T decode(SnapshotReader& reader) {
+            auto converted_value = Converter().from_str(reader.read_string());
+            if (!converted_value) {
+                throw ArgParseConversionError(converted_value.error());
+            }
+            return converted_value.value();
+        }
+    };
+
+    template<typename T, typename Converter>
+    struct SnapshotCodec<T, Converter, typename std::enable_if<std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value>::type> {
+        static void encode(SnapshotWriter& writer, const T& value) { writer.write_pod(value); }
+        static T decode(SnapshotReader& reader) { return reader.read_pod<T>(); }
+    };
+
+    template<typename Converter>
+    struct SnapshotCodec<std::string, Converter> {
+        static void encode(SnapshotWriter& writer, const std::string& value) { writer.write_string(value); }
+        static std::string decode(SnapshotReader& reader) { return reader.read_string(); }
+    };
+
+} //namespace
+#endif
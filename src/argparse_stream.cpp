@@ -0,0 +1,124 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+# include <unistd.h>
+#endif
+
+#include "argparse.hpp"
+
+namespace argparse {
+
+    double StreamStats::records_per_second() const {
+        return (seconds > 0.) ? num_records / seconds : 0.;
+    }
+
+#ifndef _WIN32
+    StreamStats ArgumentParser::parse_stream(int fd, RecordCallback callback, size_t chunk_size, char record_separator) {
+        if (chunk_size == 0) {
+            throw ArgParseError("Stream chunk size must be non-zero");
+        } else if (record_separator == '\0') {
+            throw ArgParseError("Stream record separator can not be NUL (which terminates arguments)");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        StreamStats stats;
+
+        //Input is split into arguments in place: only the end of each argument of the current
+        //(incomplete) command-line is recorded, relative to the command-line's start in the buffer.
+        //Once parsed, a command-line's input is dropped from the buffer before the next read.
+        std::vector<char> buffer(chunk_size);
+        size_t size = 0;         //Bytes of input in buffer
+        size_t record_begin = 0; //Start of the current command-line
+        size_t arg_begin = 0;    //Start of the current argument
+        std::vector<size_t> arg_ends;
+        std::vector<std::string> arg_strs; //Re-used, so arguments rarely need allocating
+
+        auto parse_record = [&]() {
+            arg_strs.resize(arg_ends.size());
+            size_t begin = record_begin;
+            for (size_t iarg = 0; iarg < arg_ends.size(); ++iarg) {
+                size_t end = record_begin + arg_ends[iarg];
+                arg_strs[iarg].assign(buffer.data() + begin, end - begin);
+                begin = end + 1; //Skip the NUL
+            }
+            arg_ends.clear();
+
+            size_t record_index = stats.num_records++;
+            try {
+                parse_args_throw(arg_strs);
+            } catch (const ArgParseError& e) {
+                ++stats.num_failed;
+                callback(record_index, &e);
+                return;
+            } catch (const ArgParseHelp&) {
+                ++stats.num_failed;
+                ArgParseError e("Unexpected request for help");
+                callback(record_index, &e);
+                return;
+            } catch (const ArgParseVersion&) {
+                ++stats.num_failed;
+                ArgParseError e("Unexpected request for the version");
+                callback(record_index, &e);
+                return;
+            }
+            callback(record_index, nullptr);
+        };
+
+        bool eof = false;
+        while (!eof) {
+            //Move the incomplete command-line to the front, growing the buffer only if it leaves
+            //less than a chunk free (i.e. for command-lines longer than a chunk)
+            if (record_begin > 0) {
+                std::memmove(buffer.data(), buffer.data() + record_begin, size - record_begin);
+                size -= record_begin;
+                arg_begin -= record_begin;
+                record_begin = 0;
+            }
+            if (buffer.size() - size < chunk_size) {
+                buffer.resize(size + chunk_size);
+            }
+
+            ssize_t num_read = ::read(fd, buffer.data() + size, buffer.size() - size);
+            if (num_read < 0) {
+                if (errno == EINTR) continue;
+                throw ArgParseError(std::string("Failed to read command-lines from stream (") + std::strerror(errno) + ")");
+            }
+            eof = (num_read == 0);
+            size_t pos = size;
+            size += num_read;
+            stats.num_bytes += num_read;
+
+            //Split the new input into arguments, parsing each command-line as it is completed
+            while (pos < size) {
+                if (pos == arg_begin && buffer[pos] == record_separator) {
+                    parse_record();
+                    record_begin = arg_begin = ++pos;
+                    continue;
+                }
+
+                const void* nul = std::memchr(buffer.data() + pos, '\0', size - pos);
+                if (!nul) break; //Argument continues in the next chunk
+
+                size_t end = static_cast<const char*>(nul) - buffer.data();
+                arg_ends.push_back(end - record_begin);
+                arg_begin = pos = end + 1;
+            }
+        }
+
+        //An unterminated final argument or command-line
+        if (arg_begin < size) {
+            arg_ends.push_back(size - record_begin);
+        }
+        if (!arg_ends.empty()) {
+            parse_record();
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        stats.seconds = elapsed.count();
+        return stats;
+    }
+#endif
+
+} //namespace
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <numeric>
+
+#include "argparse_trie.hpp"
+
+namespace argparse {
+
+    constexpr size_t PrefixTrie::NO_KEY;
+
+    PrefixTrie::PrefixTrie(MemoryResource* resource)
+        : nodes_(resource)
+        {}
+
+    void PrefixTrie::build(const PmrVector<std::string>& keys) {
+        nodes_.clear();
+        max_key_size_ = 0;
+        for (const auto& key : keys) {
+            max_key_size_ = std::max(max_key_size_, key.size());
+        }
+
+        std::vector<size_t> sorted(keys.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::sort(sorted.begin(), sorted.end(), [&](size_t lhs, size_t rhs) {
+            return keys[lhs] < keys[rhs];
+        });
+
+        nodes_.emplace_back(); //Root
+        build_node(0, keys, sorted, 0, sorted.size(), 0);
+    }
+
+    void PrefixTrie::build_node(size_t node_idx, const PmrVector<std::string>& keys,
+                                const std::vector<size_t>& sorted, size_t begin, size_t end, size_t depth) {
+        nodes_[node_idx].num_keys = end - begin;
+        if (begin == end) return;
+
+        nodes_[node_idx].first_key = sorted[begin];
+
+        if (keys[sorted[begin]].size() == depth) {
+            //The shortest key (sorted first) ends here
+            nodes_[node_idx].key = sorted[begin];
+            ++begin;
+        }
+
+        //Determine the ranges of keys sharing the next character
+        std::vector<std::pair<size_t,size_t>> child_ranges;
+        for (size_t i = begin; i < end; ) {
+            char c = keys[sorted[i]][depth];
+            size_t j = i + 1;
+            while (j < end && keys[sorted[j]][depth] == c) {
+                ++j;
+            }
+            child_ranges.emplace_back(i, j);
+            i = j;
+        }
+
+        //Allocate the children contiguously, so they can be binary searched
+        size_t children_begin = nodes_.size();
+        for (const auto& range : child_ranges) {
+            Node child;
+            child.label = keys[sorted[range.first]][depth];
+            nodes_.push_back(child);
+        }
+        nodes_[node_idx].children_begin = children_begin;
+        nodes_[node_idx].children_end = nodes_.size();
+
+        for (size_t i = 0; i < child_ranges.size(); ++i) {
+            build_node(children_begin + i, keys, sorted, child_ranges[i].first, child_ranges[i].second, depth + 1);
+        }
+    }
+
+    size_t PrefixTrie::find_node(StrRef prefix) const {
+        if (nodes_.empty()) return NO_KEY;
+
+        size_t node_idx = 0;
+        for (size_t i = 0; i < prefix.size; ++i) {
+            const Node& node = nodes_[node_idx];
+            auto first = nodes_.begin() + node.children_begin;
+            auto last = nodes_.begin() + node.children_end;
+            auto iter = std::lower_bound(first, last, prefix.data[i], [](const Node& child, char c) {
+                return child.label < c;
+            });
+            if (iter == last || iter->label != prefix.data[i]) {
+                return NO_KEY;
+            }
+            node_idx = iter - nodes_.begin();
+        }
+        return node_idx;
+    }
+
+    size_t PrefixTrie::count_prefix_matches(StrRef prefix, size_t& first_key) const {
+        size_t node_idx = find_node(prefix);
+        if (node_idx == NO_KEY) {
+            first_key = NO_KEY;
+            return 0;
+        }
+        first_key = nodes_[node_idx].first_key;
+        return nodes_[node_idx].num_keys;
+    }
+
+    std::vector<size_t> PrefixTrie::prefix_matches(StrRef prefix) const {
+        std::vector<size_t> keys;
+        size_t node_idx = find_node(prefix);
+        if (node_idx != NO_KEY) {
+            collect_keys(node_idx, keys);
+        }
+        return keys;
+    }
+
+    std::vector<std::pair<size_t,size_t>> PrefixTrie::find_within_distance(StrRef word, size_t max_distance) const {
+        std::vector<std::pair<size_t,size_t>> matches;
+        if (nodes_.empty()) return matches;
+
+        //One edit distance row per trie depth
+        size_t row_size = word.size + 1;
+        std::vector<size_t> rows((max_key_size_ + 1) * row_size);
+        for (size_t j = 0; j < row_size; ++j) {
+            rows[j] = j; //Distance from the empty prefix (root)
+        }
+
+        if (nodes_[0].key != NO_KEY && word.size <= max_distance) {
+            matches.emplace_back(nodes_[0].key, word.size);
+        }
+        find_within_distance(0, 0, word, max_distance, rows, matches);
+
+        std::stable_sort(matches.begin(), matches.end(), [](const std::pair<size_t,size_t>& lhs, const std::pair<size_t,size_t>& rhs) {
+            return lhs.second < rhs.second;
+        });
+        return matches;
+    }
+
+    void PrefixTrie::find_within_distance(size_t node_idx, size_t depth, StrRef word, size_t max_distance,
+                                          std::vector<size_t>& rows, std::vector<std::pair<size_t,size_t>>& matches) const {
+        size_t row_size = word.size + 1;
+        const size_t* prev_row = &rows[depth * row_size];
+        size_t* row = &rows[(depth + 1) * row_size];
+
+        const Node& node = nodes_[node_idx];
+        for (size_t child_idx = node.children_begin; child_idx < node.children_end; ++child_idx) {
+            const Node& child = nodes_[child_idx];
+
+            row[0] = prev_row[0] + 1;
+            size_t row_min = row[0];
+            for (size_t j = 1; j < row_size; ++j) {
+                size_t substitution_cost = (word.data[j - 1] == child.label) ? 0 : 1;
+                row[j] = std::min({row[j - 1] + 1,                       //Insertion
+                                   prev_row[j] + 1,                      //Deletion
+                                   prev_row[j - 1] + substitution_cost}); //Substitution
+                row_min = std::min(row_min, row[j]);
+            }
+
+            if (child.key != NO_KEY && row[word.size] <= max_distance) {
+                matches.emplace_back(child.key, row[word.size]);
+            }
+
+            if (row_min <= max_distance) {
+                //Some extension of this prefix may still be within max_distance
+                find_within_distance(child_idx, depth + 1, word, max_distance, rows, matches);
+            }
+        }
+    }
+
+    void PrefixTrie::collect_keys(size_t node_idx, std::vector<size_t>& keys) const {
+        const Node& node = nodes_[node_idx];
+        if (node.key != NO_KEY) {
+            keys.push_back(node.key);
+        }
+        for (size_t child_idx = node.children_begin; child_idx < node.children_end; ++child_idx) {
+            collect_keys(child_idx, keys);
+        }
+    }
+
+} //namespace
@@ -0,0 +1,76 @@
+#ifndef ARGPARSE_TRIE_HPP
+#define ARGPARSE_TRIE_HPP
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "argparse_util.hpp"
+
+namespace argparse {
+
+    /*
+     * PrefixTrie is a compact (read-only) trie over a set of keys
+     *
+     * It is built once from the full key set, with the children of each
+     * node stored contiguously and sorted by character. Walking a prefix of
+     * length L therefore costs O(L) binary searches over (small) child ranges,
+     * independent of the number of keys.
+     *
+     * Keys are identified by their index in the vector passed to build().
+     */
+    class PrefixTrie {
+        public:
+            static constexpr size_t NO_KEY = size_t(-1);
+
+            //Initializes an empty trie, whose nodes are allocated from resource
+            explicit PrefixTrie(MemoryResource* resource=new_delete_resource());
+
+            //Rebuilds the trie from the specified keys
+            void build(const PmrVector<std::string>& keys);
+
+            //Returns the number of keys starting with prefix, and sets
+            //first_key to one of them (or NO_KEY if there are none)
+            size_t count_prefix_matches(StrRef prefix, size_t& first_key) const;
+
+            //Returns the indicies of all keys starting with prefix (in sorted key order)
+            std::vector<size_t> prefix_matches(StrRef prefix) const;
+
+            //Returns the (key index, edit distance) of all keys within Levenshtein distance
+            //max_distance of word, ordered by increasing distance.
+            //
+            //The search walks the trie computing one row of the edit distance matrix per node,
+            //and prunes any sub-tree whose row minimum exceeds max_distance, so only the
+            //(typically small) part of the trie near word is visited.
+            std::vector<std::pair<size_t,size_t>> find_within_distance(StrRef word, size_t max_distance) const;
+
+        private:
+            struct Node {
+                char label = '\0';
+                uint32_t children_begin = 0;
+                uint32_t children_end = 0;
+                size_t key = NO_KEY; //Key ending at this node (if any)
+                size_t first_key = NO_KEY; //First key (in sorted order) in this sub-tree
+                size_t num_keys = 0; //Number of keys in this sub-tree
+            };
+
+            //Builds the sub-tree rooted at node_idx from the sorted keys [begin, end),
+            //which share a common prefix of length depth
+            void build_node(size_t node_idx, const PmrVector<std::string>& keys,
+                            const std::vector<size_t>& sorted, size_t begin, size_t end, size_t depth);
+
+            //Returns the node reached by walking prefix from the root (or NO_KEY)
+            size_t find_node(StrRef prefix) const;
+
+            //Appends the keys in the sub-tree rooted at node_idx
+            void collect_keys(size_t node_idx, std::vector<size_t>& keys) const;
+
+            //Recursive step of find_within_distance() for the children of node_idx at the specified depth
+            void find_within_distance(size_t node_idx, size_t depth, StrRef word, size_t max_distance,
+                                      std::vector<size_t>& rows, std::vector<std::pair<size_t,size_t>>& matches) const;
+        private:
+            PmrVector<Node> nodes_;
+            size_t max_key_size_ = 0;
+    };
+
+} //namespace
+#endif
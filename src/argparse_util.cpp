@@ -4,6 +4,32 @@
 
 namespace argparse {
 
+    bool operator==(const StrRef& lhs, const StrRef& rhs) {
+        return lhs.size == rhs.size && std::memcmp(lhs.data, rhs.data, lhs.size) == 0;
+    }
+
+    size_t StrRefHash::operator()(const StrRef& str) const noexcept {
+        //FNV-1a
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < str.size; ++i) {
+            hash ^= static_cast<unsigned char>(str.data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    void Fnv1aHasher::update(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash_ ^= bytes[i];
+            hash_ *= 1099511628211ull;
+        }
+    }
+
+    void Fnv1aHasher::update(const std::string& str) {
+        update(str.c_str(), str.size() + 1);
+    }
+
     std::array<std::string,2> split_leading_dashes(std::string str) {
         auto iter = str.begin();
         while(*iter == '-') {
@@ -17,28 +43,6 @@ namespace argparse {
         return array;
     }
 
-    bool is_argument(std::string str, const std::map<std::string,std::shared_ptr<Argument>>& arg_map) {
-
-        for (const auto& kv : arg_map) {
-            auto iter = arg_map.find(str);
-
-            if (iter != arg_map.end()) {
-                //Exact match to short/long option
-                return true;
-            }
-
-            if (kv.first.size() == 2 && kv.first[0] == '-') {
-                //Check iff this is a short option with no spaces
-                if (str[0] == kv.first[0] && str[1] == kv.first[1]) {
-                    //Matches first two characters
-                    return true;
-                }
-            }
-
-        }
-        return false;
-    }
-
     bool is_valid_choice(std::string str, const std::vector<std::string>& choices) {
         if (choices.empty()) return true;
 
@@ -49,6 +53,16 @@ namespace argparse {
         return true;
     }
 
+    bool values_equal(const char* lhs, const char* rhs) {
+        if (lhs == rhs) return true;
+        if (!lhs || !rhs) return false;
+        return std::strcmp(lhs, rhs) == 0;
+    }
+
+    bool values_equal(char* lhs, char* rhs) {
+        return values_equal(static_cast<const char*>(lhs), static_cast<const char*>(rhs));
+    }
+
     std::string toupper(std::string str) {
         std::string upper;
         for (size_t i = 0; i < str.size(); ++i) {
@@ -67,50 +81,109 @@ namespace argparse {
         return lower;
     }
 
-    char* strdup(const char* str) {
-        size_t len = std::strlen(str);
-        char* res = new char[len+1]; //+1 for terminator
-        std::strcpy(res, str);
-        return res;
+    constexpr size_t StringArena::MIN_BLOCK_SIZE;
+
+    StringArena::StringArena(MemoryResource* resource)
+        : resource_(resource)
+        , blocks_(resource)
+        {}
+
+    StringArena::StringArena(StringArena&& other) noexcept
+        : resource_(other.resource_)
+        , blocks_(std::move(other.blocks_))
+        , block_idx_(other.block_idx_)
+        , block_pos_(other.block_pos_)
+        , size_(other.size_) {
+        other.blocks_.clear(); //The blocks are now owned by this arena
     }
 
-    std::vector<std::string> wrap_width(std::string str, size_t width, std::vector<std::string> break_strs) {
-        std::vector<std::string> wrapped_lines;
+    StringArena::~StringArena() {
+        for (const auto& block : blocks_) {
+            resource_->deallocate(block.data, block.size, 1);
+        }
+    }
 
-        size_t start = 0;
-        size_t end = 0;
-        size_t last_break = 0;
-        for(end = 0; end < str.size(); ++end) {
+    char* StringArena::store(const std::string& str) {
+        size_t size = str.size() + 1;
 
-            size_t len = end - start;
+        //Find a block with space, re-using those from before the last reset
+        while (block_idx_ < blocks_.size() && blocks_[block_idx_].size - block_pos_ < size) {
+            ++block_idx_;
+            block_pos_ = 0;
+        }
+        if (block_idx_ == blocks_.size()) {
+            blocks_.reserve(blocks_.size() + 1); //So the push_back() below can not throw and leak the block
+            Block block;
+            block.size = std::max(MIN_BLOCK_SIZE, size);
+            block.data = static_cast<char*>(resource_->allocate(block.size, 1));
+            blocks_.push_back(block);
+            block_pos_ = 0;
+        }
 
-            if (len > width) {
-                auto wrapped_line = std::string(str, start, last_break - start) + "\n";
-                wrapped_lines.push_back(wrapped_line);
-                start = last_break;
-            }
+        char* copy = blocks_[block_idx_].data + block_pos_;
+        std::memcpy(copy, str.c_str(), size);
+        block_pos_ += size;
+        size_ += size;
+        return copy;
+    }
 
-            //Find the next break
-            for (const auto& brk_str : break_strs) {
-                auto pos = str.find(brk_str, end); //FIXME: this is inefficient
-                if (pos == end) {
-                    last_break = end + 1;
-                }
-            }
+    void StringArena::reset() {
+        block_idx_ = 0;
+        block_pos_ = 0;
+        size_ = 0;
+    }
 
-            //If there are embedded new-lines then take them as forced breaks
-            char c = str[end];
-            if (c == '\n') {
-                last_break = end + 1;
-                auto wrapped_line = std::string(str, start, last_break - start);
-                wrapped_lines.push_back(wrapped_line);
-                start = last_break;
-            }
+    size_t StringArena::size() const {
+        return size_;
+    }
+
+    size_t StringArena::capacity() const {
+        size_t total = 0;
+        for (const auto& block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+    namespace {
+        thread_local StringArena* string_arena = nullptr;
+    }
+
+    StringArena* current_string_arena() {
+        return string_arena;
+    }
+
+    StringArenaScope::StringArenaScope(StringArena* arena)
+        : prev_arena_(string_arena) {
+        string_arena = arena;
+    }
+
+    StringArenaScope::~StringArenaScope() {
+        string_arena = prev_arena_;
+    }
+
+    char* arena_strdup(const std::string& str) {
+        if (string_arena) {
+            return string_arena->store(str);
         }
+        return strdup(str.c_str());
+    }
 
-        auto last_line = std::string(str, start, end - start);
-        wrapped_lines.push_back(last_line);
+    char* strdup(const char* str) {
+        size_t len = std::strlen(str);
+        char* res = new char[len+1]; //+1 for terminator
+        std::strcpy(res, str);
+        return res;
+    }
 
+    std::vector<std::string> wrap_width(std::string str, size_t width, std::vector<std::string> break_strs) {
+        std::vector<std::string> wrapped_lines;
+        visit_wrapped_lines(str, width, break_strs, [&](StrRef line, bool wrapped) {
+            wrapped_lines.emplace_back(line.data, line.size);
+            if (wrapped) {
+                wrapped_lines.back() += "\n";
+            }
+        });
         return wrapped_lines;
     }
 
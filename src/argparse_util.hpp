@@ -1,13 +1,122 @@
 #ifndef ARGPARSE_UTIL_HPP
 #define ARGPARSE_UTIL_HPP
+#include <algorithm>
 #include <array>
+#include <string>
 #include <vector>
 #include <map>
 #include <memory>
+#include <type_traits>
+#include <cstdint>
+
+#include "argparse_memory.hpp"
 
 namespace argparse {
     class Argument;
 
+    //A non-owning reference to a (not necessarily null-terminated) sequence of characters
+    struct StrRef {
+        constexpr StrRef() = default;
+        constexpr StrRef(const char* data_ptr, size_t len) : data(data_ptr), size(len) {}
+        StrRef(const std::string& str) : data(str.data()), size(str.size()) {}
+
+        //From a string literal, allowing constant-initialized (rather than dynamically initialized) globals
+        template<size_t N>
+        constexpr StrRef(const char (&str)[N]) : data(str), size(N - 1) {}
+
+        const char* data = nullptr;
+        size_t size = 0;
+    };
+
+    bool operator==(const StrRef& lhs, const StrRef& rhs);
+
+    struct StrRefHash {
+        size_t operator()(const StrRef& str) const noexcept;
+    };
+
+    //Incrementally computes the 64-bit FNV-1a hash of a sequence of bytes
+    class Fnv1aHasher {
+        public:
+            void update(const void* data, size_t size);
+
+            //Hashes str followed by a terminator, so consecutive strings can not alias
+            void update(const std::string& str);
+
+            uint64_t hash() const { return hash_; }
+        private:
+            uint64_t hash_ = 14695981039346656037ull;
+    };
+
+    //A fixed-size set of bits, sized at run-time
+    class DynamicBitset {
+        public:
+            DynamicBitset() = default;
+            explicit DynamicBitset(size_t num_bits) { resize(num_bits); }
+
+            //Resizes to num_bits, with all bits cleared
+            void resize(size_t num_bits) {
+                num_bits_ = num_bits;
+                words_.assign((num_bits + WORD_BITS - 1) / WORD_BITS, 0);
+            }
+
+            size_t size() const { return num_bits_; }
+
+            void set(size_t idx) { words_[idx / WORD_BITS] |= bit(idx); }
+            void reset(size_t idx) { words_[idx / WORD_BITS] &= ~bit(idx); }
+            bool test(size_t idx) const { return words_[idx / WORD_BITS] & bit(idx); }
+
+            //Clears all bits
+            void clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+            //Returns true if any bit is set
+            bool any() const {
+                for (uint64_t word : words_) {
+                    if (word) return true;
+                }
+                return false;
+            }
+
+            //Returns true if any bit is set in both this and other (which must be the same size)
+            bool intersects(const DynamicBitset& other) const {
+                for (size_t i = 0; i < words_.size(); ++i) {
+                    if (words_[i] & other.words_[i]) return true;
+                }
+                return false;
+            }
+
+            //Returns the number of bits set in both this and other (which must be the same size)
+            size_t count_common(const DynamicBitset& other) const {
+                size_t count = 0;
+                for (size_t i = 0; i < words_.size(); ++i) {
+                    count += popcount(words_[i] & other.words_[i]);
+                }
+                return count;
+            }
+
+            //Returns true if every bit set in this is also set in other (which must be the same size)
+            bool is_subset_of(const DynamicBitset& other) const {
+                for (size_t i = 0; i < words_.size(); ++i) {
+                    if (words_[i] & ~other.words_[i]) return false;
+                }
+                return true;
+            }
+
+        private:
+            static constexpr size_t WORD_BITS = 64;
+            static uint64_t bit(size_t idx) { return uint64_t(1) << (idx % WORD_BITS); }
+
+            //Returns the number of bits set in word
+            static size_t popcount(uint64_t word) {
+                word = word - ((word >> 1) & 0x5555555555555555ull);
+                word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+                word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+                return (word * 0x0101010101010101ull) >> 56;
+            }
+
+            std::vector<uint64_t> words_;
+            size_t num_bits_ = 0;
+    };
+
     //Splits off the leading dashes of a string, returning the dashes (index 0)
     //and the rest of the string (index 1)
     std::array<std::string,2> split_leading_dashes(std::string str);
@@ -18,10 +127,6 @@ namespace argparse {
     //Converts a string to lower case
     std::string tolower(std::string str);
 
-    //Returns true if str represents a named argument starting with
-    //'-' or '--' followed by one or more letters
-    bool is_argument(std::string str, const std::map<std::string,std::shared_ptr<Argument>>& arg_map);
-
     //Returns true if str is in choices, or choices is empty
     bool is_valid_choice(std::string str, const std::vector<std::string>& choices);
 
@@ -33,10 +138,116 @@ namespace argparse {
     template<typename Container>
     std::string join(Container container, std::string join_str);
 
+    //Returns true if lhs and rhs are equal. Types without operator== are
+    //conservatively treated as never equal.
+    template<typename T>
+    bool values_equal(const T& lhs, const T& rhs);
+    bool values_equal(const char* lhs, const char* rhs);
+    bool values_equal(char* lhs, char* rhs);
+
+    //Records a copy of a value, to later check whether it has changed
+    template<typename T>
+    class ValueSnapshot {
+        public:
+            void set(const T& value) { value_ = value; }
+            bool equals(const T& value) const { return values_equal(value, value_); }
+        private:
+            T value_ = T();
+    };
+
+    //C-string values are copied, since the storage they point to may be re-used
+    template<typename CharPtr>
+    class CStrSnapshot {
+        public:
+            void set(CharPtr value) {
+                is_null_ = !value;
+                value_ = value ? value : "";
+            }
+            bool equals(CharPtr value) const {
+                if (!value) return is_null_;
+                return !is_null_ && value_ == value;
+            }
+        private:
+            std::string value_;
+            bool is_null_ = true;
+    };
+    template<>
+    class ValueSnapshot<const char*> : public CStrSnapshot<const char*> {};
+    template<>
+    class ValueSnapshot<char*> : public CStrSnapshot<char*> {};
+
+    /*
+     * StringArena is a monotonic allocator for (null-terminated) strings
+     *
+     * Strings are packed into large blocks, so storing a string usually involves
+     * no heap allocation. reset() releases all strings at once, but keeps the
+     * blocks for re-use, so repeatedly storing and resetting uses bounded memory.
+     * Blocks are allocated from the memory resource specified on construction.
+     */
+    class StringArena {
+        public:
+            explicit StringArena(MemoryResource* resource=new_delete_resource());
+            ~StringArena();
+
+            StringArena(StringArena&& other) noexcept;
+            StringArena(const StringArena&) = delete;
+            StringArena& operator=(const StringArena&) = delete;
+
+            //Returns a null-terminated copy of str, valid until the next reset()
+            char* store(const std::string& str);
+
+            //Invalidates all stored strings, making their memory available for re-use
+            void reset();
+
+            //Returns the total size of the strings stored since the last reset() (including terminators)
+            size_t size() const;
+
+            //Returns the total size of the allocated blocks
+            size_t capacity() const;
+        private:
+            static constexpr size_t MIN_BLOCK_SIZE = 4096;
+
+            struct Block {
+                char* data = nullptr;
+                size_t size = 0;
+            };
+            MemoryResource* resource_;
+            PmrVector<Block> blocks_;
+            size_t block_idx_ = 0; //Block currently being filled
+            size_t block_pos_ = 0; //Next free byte in the current block
+            size_t size_ = 0;
+    };
+
+    //Returns the arena in which converters should store C-strings for the parse in progress
+    //on this thread, or nullptr if there is none (see StringArenaScope)
+    StringArena* current_string_arena();
+
+    //Sets the current string arena (which may be nullptr) for its lifetime
+    class StringArenaScope {
+        public:
+            StringArenaScope(StringArena* arena);
+            ~StringArenaScope();
+
+            StringArenaScope(const StringArenaScope&) = delete;
+            StringArenaScope& operator=(const StringArenaScope&) = delete;
+        private:
+            StringArena* prev_arena_;
+    };
+
     char* strdup(const char* str);
 
+    //Returns a copy of str stored in the current string arena, or allocated
+    //by strdup() (which the caller must free) if there is no current arena
+    char* arena_strdup(const std::string& str);
+
     std::vector<std::string> wrap_width(std::string str, size_t width, std::vector<std::string> split_str);
 
+    //Calls visitor(StrRef line, bool wrapped) for each of the lines wrap_width() would return,
+    //without copying them. Wrapped lines exclude the new-line wrap_width() appends to them.
+    //break_strs may be any range of strings convertible to StrRef (e.g. an array of StrRef).
+    template<typename BreakStrs, typename Visitor>
+    void visit_wrapped_lines(const std::string& str, size_t width, const BreakStrs& break_strs, Visitor visitor);
+
     std::string basename(std::string filepath);
 } //namespace
 
@@ -1,5 +1,5 @@
 #include <sstream>
-#include "argparse.hpp"
+#include "argparse_error.hpp"
 
 namespace argparse {
 
@@ -31,4 +31,66 @@ namespace argparse {
 
         return ss.str();
     }
+
+    //Detects whether an operator== is declared for T
+    template<typename T, typename = void>
+    struct has_equality_operator : std::false_type {};
+
+    template<typename T>
+    struct has_equality_operator<T, decltype(void(std::declval<const T&>() == std::declval<const T&>()))> : std::true_type {};
+
+    //Detects whether T supports operator==
+    template<typename T>
+    struct is_equality_comparable : has_equality_operator<T> {};
+
+    //std::vector declares operator== for any element type, so check the elements instead
+    template<typename T, typename Alloc>
+    struct is_equality_comparable<std::vector<T,Alloc>> : is_equality_comparable<T> {};
+
+    template<typename T>
+    typename std::enable_if<is_equality_comparable<T>::value, bool>::type
+    values_equal_impl(const T& lhs, const T& rhs) { return lhs == rhs; }
+
+    template<typename T>
+    typename std::enable_if<!is_equality_comparable<T>::value, bool>::type
+    values_equal_impl(const T& /*lhs*/, const T& /*rhs*/) { return false; }
+
+    template<typename T>
+    bool values_equal(const T& lhs, const T& rhs) {
+        return values_equal_impl(lhs, rhs);
+    }
+
+    template<typename BreakStrs, typename Visitor>
+    void visit_wrapped_lines(const std::string& str, size_t width, const BreakStrs& break_strs, Visitor visitor) {
+        size_t start = 0;
+        size_t end = 0;
+        size_t last_break = 0;
+        for(end = 0; end < str.size(); ++end) {
+
+            size_t len = end - start;
+
+            if (len > width) {
+                visitor(StrRef(str.data() + start, last_break - start), true);
+                start = last_break;
+            }
+
+            //Find the next break
+            for (const auto& brk_str : break_strs) {
+                StrRef brk(brk_str);
+                if (str.compare(end, brk.size, brk.data, brk.size) == 0) {
+                    last_break = end + 1;
+                }
+            }
+
+            //If there are embedded new-lines then take them as forced breaks
+            char c = str[end];
+            if (c == '\n') {
+                last_break = end + 1;
+                visitor(StrRef(str.data() + start, last_break - start), false);
+                start = last_break;
+            }
+        }
+
+        visitor(StrRef(str.data() + start, end - start), false);
+    }
 }
@@ -0,0 +1,116 @@
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "argparse_value.hpp"
+
+namespace argparse {
+
+    namespace {
+        /*
+         * Interned strings are stored in chunks of doubling size, which are never moved or freed,
+         * and the number of strings is published (atomically) after each is stored. Lookups
+         * therefore never lock: only interning (which must check for an existing id) does.
+         */
+        class InternTable {
+            public:
+                InternTable() {
+                    for (auto& chunk : chunks_) {
+                        chunk.store(nullptr, std::memory_order_relaxed);
+                    }
+                    add(std::string()); //EMPTY_STRING_ID
+                }
+
+                ~InternTable() {
+                    for (auto& chunk : chunks_) {
+                        delete[] chunk.load(std::memory_order_relaxed);
+                    }
+                }
+
+                StringId intern(const std::string& str) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+
+                    auto iter = ids_.find(str);
+                    if (iter != ids_.end()) {
+                        return iter->second;
+                    }
+                    return add(str);
+                }
+
+                const std::string& lookup(StringId id) const {
+                    if (id >= size_.load(std::memory_order_acquire)) {
+                        throw std::out_of_range("Invalid interned string id");
+                    }
+                    size_t ichunk, offset;
+                    locate(id, ichunk, offset);
+                    return chunks_[ichunk].load(std::memory_order_relaxed)[offset];
+                }
+            private:
+                static constexpr size_t FIRST_CHUNK_SIZE = 64;
+                static constexpr size_t MAX_CHUNKS = 32; //Enough for every StringId
+
+                //Finds the chunk (and offset within it) of id. Chunk i holds FIRST_CHUNK_SIZE << i
+                //strings, starting at id FIRST_CHUNK_SIZE * (2^i - 1).
+                static void locate(StringId id, size_t& ichunk, size_t& offset) {
+                    size_t n = id / FIRST_CHUNK_SIZE + 1;
+                    ichunk = 0;
+                    while (n >>= 1) {
+                        ++ichunk;
+                    }
+                    offset = id - FIRST_CHUNK_SIZE * ((size_t(1) << ichunk) - 1);
+                }
+
+                //Stores str with the next id (with mutex_ held, or during construction)
+                StringId add(const std::string& str) {
+                    StringId id = size_.load(std::memory_order_relaxed);
+                    size_t ichunk, offset;
+                    locate(id, ichunk, offset);
+                    std::string* chunk = chunks_[ichunk].load(std::memory_order_relaxed);
+                    if (!chunk) {
+                        chunk = new std::string[FIRST_CHUNK_SIZE << ichunk];
+                        chunks_[ichunk].store(chunk, std::memory_order_relaxed);
+                    }
+                    chunk[offset] = str;
+                    ids_[str] = id;
+
+                    //Publish the string (and any new chunk) to lookup()
+                    size_.store(id + 1, std::memory_order_release);
+                    return id;
+                }
+            private:
+                std::mutex mutex_;
+                std::unordered_map<std::string,StringId> ids_;
+                std::atomic<std::string*> chunks_[MAX_CHUNKS];
+                std::atomic<StringId> size_{0};
+        };
+
+        constexpr size_t InternTable::FIRST_CHUNK_SIZE;
+        constexpr size_t InternTable::MAX_CHUNKS;
+
+        InternTable& intern_table() {
+            static InternTable table;
+            return table;
+        }
+    }
+
+    const char* provenance_name(Provenance prov) {
+        switch (prov) {
+            case Provenance::UNSPECIFIED: return "unspecified";
+            case Provenance::DEFAULT: return "default";
+            case Provenance::SPECIFIED: return "specified";
+            case Provenance::INFERRED: return "inferred";
+            default: throw ArgParseError("Unrecognized provenance");
+        }
+    }
+
+    StringId intern_string(const std::string& str) {
+        if (str.empty()) return EMPTY_STRING_ID;
+        return intern_table().intern(str);
+    }
+
+    const std::string& interned_string(StringId id) {
+        return intern_table().lookup(id);
+    }
+
+} //namespace
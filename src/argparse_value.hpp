@@ -1,6 +1,8 @@
 #ifndef ARGPARSE_VALUE_HPP
 #define ARGPARSE_VALUE_HPP
-#include <iostream>
+#include <ostream>
+#include <cstdint>
+#include <utility>
 #include "argparse_error.hpp"
 
 namespace argparse {
@@ -10,10 +12,12 @@ namespace argparse {
         public:
             typedef T value_type;
         public:
-            void set_value(T val) { errored_ = false; value_ = val; }
+            void set_value(const T& val) { errored_ = false; value_ = val; }
+            void set_value(T&& val) { errored_ = false; value_ = std::move(val); }
             void set_error(std::string msg) { errored_ = true; error_msg_ = msg; }
 
-            T value() const { return value_; }
+            const T& value() const & { return value_; }
+            T value() && { return std::move(value_); } //Moves the value out of a temporary
             std::string error() const { return error_msg_; }
 
             operator bool() { return valid(); }
@@ -25,13 +29,31 @@ namespace argparse {
     };
 
     //How the value associated with an argumetn was initialized
-    enum class Provenance {
+    enum class Provenance : uint8_t {
         UNSPECIFIED,//The value was default constructed
         DEFAULT,    //The value was set by a default (e.g. as a command-line argument default value)
         SPECIFIED,  //The value was explicitly specified (e.g. explicitly specified on the command-line)
         INFERRED,   //The value was inferred, or conditionally set based on other values
     };
 
+    //Returns the name of a provenance (e.g. 'specified')
+    const char* provenance_name(Provenance prov);
+
+    //Identifies a string in the (process-wide) intern table
+    typedef uint32_t StringId;
+
+    //The id of the empty string
+    constexpr StringId EMPTY_STRING_ID = 0;
+
+    //Returns the id of str in the intern table, adding it if required.
+    //Interned strings are never removed, so ids (and the strings they refer
+    //to) remain valid for the life of the program, independent of any parser.
+    StringId intern_string(const std::string& str);
+
+    //Returns the interned string with the specified id. Does not lock, so is
+    //cheap to call concurrently (e.g. from parsers on several threads).
+    const std::string& interned_string(StringId id);
+
     /*
      * ArgValue represents the 'value' of a command-line option/argument
      *
@@ -47,21 +69,26 @@ namespace argparse {
 
         public: //Accessors
             //Automatic conversion to underlying value type
-            operator T() const { return value_; }
+            operator const T&() const { return value_; }
 
             //Returns the value assoicated with this argument
-            const T& value() const { return value_; }
+            const T& value() const & { return value_; }
+            T value() && { return std::move(value_); } //Moves the value out of a temporary
 
             //Returns the provenance of this argument (i.e. how it was initialized)
             Provenance provenance() const { return provenance_; }
 
             //Returns the group this argument is associated with (or an empty string if none)
-            const std::string& argument_group() const { return argument_group_; }
+            const std::string& argument_group() const { return interned_string(argument_group_id_); }
+
+            const std::string& argument_name() const { return interned_string(argument_name_id_); }
 
-            const std::string& argument_name() const { return argument_name_; }
+            //Returns the interned ids of argument_group() and argument_name()
+            StringId argument_group_id() const { return argument_group_id_; }
+            StringId argument_name_id() const { return argument_name_id_; }
 
         public: //Mutators
-            void set(ConvertedValue<T> val, Provenance prov) {
+            void set(const ConvertedValue<T>& val, Provenance prov) {
                 if (!val.valid()) {
                     //If the value didn't convert properly, it should
                     //have an error message so raise it
@@ -71,34 +98,61 @@ namespace argparse {
                 provenance_ = prov;
             }
 
-            void set(T val, Provenance prov) {
+            void set(ConvertedValue<T>&& val, Provenance prov) {
+                if (!val.valid()) {
+                    throw ArgParseConversionError(val.error());
+                }
+                value_ = std::move(val).value();
+                provenance_ = prov;
+            }
+
+            void set(const T& val, Provenance prov) {
                 value_ = val;
                 provenance_ = prov;
             }
 
+            void set(T&& val, Provenance prov) {
+                value_ = std::move(val);
+                provenance_ = prov;
+            }
+
+            //Sets the value to one constructed from args (which is moved into place, rather than copied)
+            template<typename... Args>
+            T& emplace(Provenance prov, Args&&... args) {
+                value_ = T(std::forward<Args>(args)...);
+                provenance_ = prov;
+                return value_;
+            }
+
             T& mutable_value(Provenance prov) {
                 provenance_ = prov;
                 return value_;
             }
 
             void set_argument_group(std::string grp) {
-                argument_group_ = grp;
+                argument_group_id_ = intern_string(grp);
             }
 
             void set_argument_name(std::string name_str) {
-                argument_name_ = name_str;
+                argument_name_id_ = intern_string(name_str);
+            }
+
+            //Sets the (already interned) argument name and group
+            void set_argument_ids(StringId name_id, StringId group_id) {
+                argument_name_id_ = name_id;
+                argument_group_id_ = group_id;
             }
         private:
             T value_ = T();
             Provenance provenance_ = Provenance::UNSPECIFIED;
-            std::string argument_group_ = "";
-            std::string argument_name_ = "";
+            StringId argument_name_id_ = EMPTY_STRING_ID;
+            StringId argument_group_id_ = EMPTY_STRING_ID;
     };
 
     //Automatically convert to the underlying type for ostream output
     template<typename T>
-    std::ostream& operator<<(std::ostream& os, const ArgValue<T> t) {
-        return os << T(t);
+    std::ostream& operator<<(std::ostream& os, const ArgValue<T>& t) {
+        return os << t.value();
     }
 
 }